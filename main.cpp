@@ -1,9 +1,12 @@
 #include <QApplication>
 #include "src/MainMenuWidget.h"
+#include "src/engine/EnginePool.h"
 
 
 int main(int argc, char* argv[]) {
     QApplication app(argc, argv);
+    // Spawn and handshake the engine while the menu is shown, not when the first game starts.
+    EnginePool::instance().warmUp();
     MainMenuWidget mainmenu;
     mainmenu.show();
 
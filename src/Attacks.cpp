@@ -0,0 +1,158 @@
+#include "Attacks.h"
+
+#include <vector>
+
+namespace Attacks {
+    Bitboard pawnAttacks[2][64];
+    Bitboard knightAttacks[64];
+    Bitboard kingAttacks[64];
+    Magic rookMagics[64];
+    Magic bishopMagics[64];
+    Bitboard betweenBB[64][64];
+    Bitboard lineBB[64][64];
+}
+
+namespace {
+    constexpr int ROOK_DIRS[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+    constexpr int BISHOP_DIRS[4][2] = {{1, 1}, {1, -1}, {-1, 1}, {-1, -1}};
+    constexpr int KNIGHT_OFFSETS[8][2] = {{2, 1}, {2, -1}, {-2, 1}, {-2, -1}, {1, 2}, {1, -2}, {-1, 2}, {-1, -2}};
+    constexpr int KING_OFFSETS[8][2] = {{1, 1}, {1, 0}, {1, -1}, {0, 1}, {0, -1}, {-1, 1}, {-1, 0}, {-1, -1}};
+
+    Bitboard rookTable[0x19000];
+    Bitboard bishopTable[0x1480];
+
+    inline bool inside(int row, int col) noexcept {
+        return row >= 0 && row < 8 && col >= 0 && col < 8;
+    }
+
+    Bitboard slidingAttack(const int (&dirs)[4][2], int sq, Bitboard occupied) {
+        Bitboard result = 0;
+        for (auto &d: dirs) {
+            int r = bb::rowOf(sq) + d[0], c = bb::colOf(sq) + d[1];
+            for (; inside(r, c); r += d[0], c += d[1]) {
+                result |= bb::squareBB(bb::square(r, c));
+                if (occupied & bb::squareBB(bb::square(r, c))) break;
+            }
+        }
+        return result;
+    }
+
+    template<std::size_t N>
+    Bitboard stepAttack(const int (&offsets)[N][2], int sq) {
+        Bitboard result = 0;
+        for (auto &o: offsets) {
+            int r = bb::rowOf(sq) + o[0], c = bb::colOf(sq) + o[1];
+            if (inside(r, c)) result |= bb::squareBB(bb::square(r, c));
+        }
+        return result;
+    }
+
+    // xorshift64*; fixed seeds keep the magic search deterministic and fast.
+    class Prng {
+    public:
+        explicit Prng(std::uint64_t seed) : s_(seed) {}
+
+        std::uint64_t next() noexcept {
+            s_ ^= s_ >> 12;
+            s_ ^= s_ << 25;
+            s_ ^= s_ >> 27;
+            return s_ * 2685821657736338717ULL;
+        }
+
+        std::uint64_t sparse() noexcept { return next() & next() & next(); }
+
+    private:
+        std::uint64_t s_;
+    };
+
+    void initMagics(const int (&dirs)[4][2], Bitboard *table, Attacks::Magic *magics) {
+        std::vector<Bitboard> occupancy(4096), reference(4096);
+#if !defined(__BMI2__)
+        static constexpr std::uint64_t SEEDS[8] = {728, 10316, 55013, 32803, 12281, 15100, 16645, 255};
+        std::vector<int> epoch(4096, 0);
+        int attempt = 0;
+#endif
+
+        for (int sq = 0; sq < 64; ++sq) {
+            const int row = bb::rowOf(sq), col = bb::colOf(sq);
+            const Bitboard edges = ((bb::RANK_1 | bb::RANK_8) & ~bb::rankBB(row))
+                                   | ((bb::FILE_A | bb::FILE_H) & ~bb::fileBB(col));
+            Attacks::Magic &m = magics[sq];
+            m.mask = slidingAttack(dirs, sq, 0) & ~edges;
+            m.shift = 64 - bb::popCount(m.mask);
+            m.attacks = sq == 0 ? table : magics[sq - 1].attacks + (std::size_t{1} << (64 - magics[sq - 1].shift));
+
+            int size = 0;
+            Bitboard b = 0;
+            do {
+                occupancy[size] = b;
+                reference[size] = slidingAttack(dirs, sq, b);
+#if defined(__BMI2__)
+                m.attacks[m.index(b)] = reference[size];
+#endif
+                ++size;
+                b = (b - m.mask) & m.mask;
+            } while (b);
+
+#if !defined(__BMI2__)
+            Prng rng(SEEDS[row]);
+            for (int i = 0; i < size;) {
+                for (m.magic = 0; bb::popCount((m.magic * m.mask) >> 56) < 6;) {
+                    m.magic = rng.sparse();
+                }
+                ++attempt;
+                for (i = 0; i < size; ++i) {
+                    const unsigned idx = m.index(occupancy[i]);
+                    if (epoch[idx] < attempt) {
+                        epoch[idx] = attempt;
+                        m.attacks[idx] = reference[i];
+                    } else if (m.attacks[idx] != reference[i]) {
+                        break;
+                    }
+                }
+            }
+#endif
+        }
+    }
+
+    struct TableInit {
+        TableInit() {
+            for (int sq = 0; sq < 64; ++sq) {
+                const Bitboard b = bb::squareBB(sq);
+                Attacks::pawnAttacks[0][sq] = ((b << 7) & ~bb::FILE_H) | ((b << 9) & ~bb::FILE_A);
+                Attacks::pawnAttacks[1][sq] = ((b >> 9) & ~bb::FILE_H) | ((b >> 7) & ~bb::FILE_A);
+                Attacks::knightAttacks[sq] = stepAttack(KNIGHT_OFFSETS, sq);
+                Attacks::kingAttacks[sq] = stepAttack(KING_OFFSETS, sq);
+            }
+            initMagics(ROOK_DIRS, rookTable, Attacks::rookMagics);
+            initMagics(BISHOP_DIRS, bishopTable, Attacks::bishopMagics);
+
+            for (int a = 0; a < 64; ++a) {
+                for (int b = 0; b < 64; ++b) {
+                    const Bitboard ab = bb::squareBB(a) | bb::squareBB(b);
+                    if (a != b && (Attacks::rook(a, 0) & bb::squareBB(b))) {
+                        Attacks::lineBB[a][b] = (Attacks::rook(a, 0) & Attacks::rook(b, 0)) | ab;
+                        Attacks::betweenBB[a][b] = Attacks::rook(a, ab) & Attacks::rook(b, ab);
+                    } else if (a != b && (Attacks::bishop(a, 0) & bb::squareBB(b))) {
+                        Attacks::lineBB[a][b] = (Attacks::bishop(a, 0) & Attacks::bishop(b, 0)) | ab;
+                        Attacks::betweenBB[a][b] = Attacks::bishop(a, ab) & Attacks::bishop(b, ab);
+                    }
+                }
+            }
+        }
+    };
+
+    const TableInit tableInit;
+}
+
+Bitboard Attacks::attacks(PieceType type, Color color, int sq, Bitboard occupied) noexcept {
+    switch (type) {
+        case PieceType::Pawn: return pawn(color, sq);
+        case PieceType::Knight: return knight(sq);
+        case PieceType::Bishop: return bishop(sq, occupied);
+        case PieceType::Rook: return rook(sq, occupied);
+        case PieceType::Queen: return queen(sq, occupied);
+        case PieceType::King: return king(sq);
+    }
+    return 0;
+}
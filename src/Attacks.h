@@ -0,0 +1,66 @@
+#ifndef ATTACKS_H
+#define ATTACKS_H
+
+#include "Bitboard.h"
+#include "Piece.h"
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+namespace Attacks {
+    struct Magic {
+        Bitboard mask;
+        Bitboard magic;
+        Bitboard *attacks;
+        unsigned shift;
+
+        [[nodiscard]] unsigned index(Bitboard occupied) const noexcept {
+#if defined(__BMI2__)
+            return static_cast<unsigned>(_pext_u64(occupied, mask));
+#else
+            return static_cast<unsigned>(((occupied & mask) * magic) >> shift);
+#endif
+        }
+    };
+
+    extern Bitboard pawnAttacks[2][64];
+    extern Bitboard knightAttacks[64];
+    extern Bitboard kingAttacks[64];
+    extern Magic rookMagics[64];
+    extern Magic bishopMagics[64];
+    extern Bitboard betweenBB[64][64];
+    extern Bitboard lineBB[64][64];
+
+    inline Bitboard pawn(Color color, int sq) noexcept {
+        return pawnAttacks[static_cast<int>(color)][sq];
+    }
+
+    inline Bitboard knight(int sq) noexcept { return knightAttacks[sq]; }
+
+    inline Bitboard king(int sq) noexcept { return kingAttacks[sq]; }
+
+    inline Bitboard rook(int sq, Bitboard occupied) noexcept {
+        const Magic &m = rookMagics[sq];
+        return m.attacks[m.index(occupied)];
+    }
+
+    inline Bitboard bishop(int sq, Bitboard occupied) noexcept {
+        const Magic &m = bishopMagics[sq];
+        return m.attacks[m.index(occupied)];
+    }
+
+    inline Bitboard queen(int sq, Bitboard occupied) noexcept {
+        return rook(sq, occupied) | bishop(sq, occupied);
+    }
+
+    // Squares strictly between a and b, empty if they do not share a line.
+    inline Bitboard between(int a, int b) noexcept { return betweenBB[a][b]; }
+
+    // The whole rank, file or diagonal through a and b, empty if none.
+    inline Bitboard line(int a, int b) noexcept { return lineBB[a][b]; }
+
+    Bitboard attacks(PieceType type, Color color, int sq, Bitboard occupied) noexcept;
+}
+
+#endif //ATTACKS_H
@@ -0,0 +1,33 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <bit>
+#include <cstdint>
+
+using Bitboard = std::uint64_t;
+
+namespace bb {
+    constexpr Bitboard FILE_A = 0x0101010101010101ULL;
+    constexpr Bitboard FILE_H = FILE_A << 7;
+    constexpr Bitboard RANK_1 = 0xFFULL;
+    constexpr Bitboard RANK_8 = RANK_1 << 56;
+
+    constexpr int square(int row, int col) noexcept { return row * 8 + col; }
+    constexpr int rowOf(int sq) noexcept { return sq >> 3; }
+    constexpr int colOf(int sq) noexcept { return sq & 7; }
+
+    constexpr Bitboard squareBB(int sq) noexcept { return Bitboard{1} << sq; }
+    constexpr Bitboard fileBB(int col) noexcept { return FILE_A << col; }
+    constexpr Bitboard rankBB(int row) noexcept { return RANK_1 << (8 * row); }
+
+    inline int popCount(Bitboard b) noexcept { return std::popcount(b); }
+    inline int lsb(Bitboard b) noexcept { return std::countr_zero(b); }
+
+    inline int popLsb(Bitboard &b) noexcept {
+        int sq = lsb(b);
+        b &= b - 1;
+        return sq;
+    }
+}
+
+#endif //BITBOARD_H
@@ -1,77 +1,165 @@
 #include "Board.h"
+#include "Zobrist.h"
 
-const std::optional<Piece> &Board::pieceAt(int row, int col) const {
-    return board_[row][col];
+std::optional<Piece> Board::pieceAt(int row, int col) const noexcept {
+    return pieceOn(bb::square(row, col));
 }
 
-std::optional<Piece> &Board::pieceAt(int row, int col) {
-    return board_[row][col];
+std::optional<Piece> Board::pieceOn(int sq) const noexcept {
+    const std::uint8_t code = mailbox_[sq];
+    if (code == NO_PIECE) return std::nullopt;
+    return Piece(static_cast<PieceType>(code % 6), static_cast<Color>(code / 6));
+}
+
+void Board::setPiece(int row, int col, const std::optional<Piece> &piece) {
+    int sq = bb::square(row, col);
+    removePiece(sq);
+    if (piece) putPiece(sq, *piece);
 }
 
 bool Board::isInside(int row, int col) const noexcept {
     return row >= 0 && row < SIZE && col >= 0 && col < SIZE;
 }
 
-void Board::initialize() {
-    for (auto &row: board_) {
-        for (auto &cell: row) {
-            cell.reset();
-        }
-    }
+int Board::kingSquare(Color color) const noexcept {
+    Bitboard king = pieces(color, PieceType::King);
+    return king ? bb::lsb(king) : -1;
+}
 
-    board_[0][0] = Piece(PieceType::Rook, Color::White);
-    board_[0][1] = Piece(PieceType::Knight, Color::White);
-    board_[0][2] = Piece(PieceType::Bishop, Color::White);
-    board_[0][3] = Piece(PieceType::Queen, Color::White);
-    board_[0][4] = Piece(PieceType::King, Color::White);
-    board_[0][5] = Piece(PieceType::Bishop, Color::White);
-    board_[0][6] = Piece(PieceType::Knight, Color::White);
-    board_[0][7] = Piece(PieceType::Rook, Color::White);
-    for (int col = 0; col < SIZE; ++col) {
-        board_[1][col] = Piece(PieceType::Pawn, Color::White);
-    }
+void Board::putPiece(int sq, Piece piece) noexcept {
+    const Bitboard b = bb::squareBB(sq);
+    byType_[static_cast<int>(piece.type())] |= b;
+    byColor_[static_cast<int>(piece.color())] |= b;
+    mailbox_[sq] = encode(piece);
+    key_ ^= Zobrist::piece(piece, sq);
+    if (piece.type() == PieceType::Pawn) pawnKey_ ^= Zobrist::piece(piece, sq);
+    psq_ += Psqt::piece(piece, sq);
+    phase_ += Psqt::phase(piece);
+}
+
+void Board::removePiece(int sq) noexcept {
+    const std::uint8_t code = mailbox_[sq];
+    if (code == NO_PIECE) return;
+    const Bitboard b = bb::squareBB(sq);
+    byType_[code % 6] &= ~b;
+    byColor_[code / 6] &= ~b;
+    mailbox_[sq] = NO_PIECE;
+    key_ ^= Zobrist::KEYS.pieces[code / 6][code % 6][sq];
+    if (code % 6 == static_cast<int>(PieceType::Pawn)) pawnKey_ ^= Zobrist::KEYS.pieces[code / 6][code % 6][sq];
+    psq_ -= Psqt::SCORES[code / 6][code % 6][sq];
+    phase_ -= Psqt::PHASE_WEIGHT[code % 6];
+}
+
+void Board::movePiece(int from, int to) noexcept {
+    const std::uint8_t code = mailbox_[from];
+    if (code == NO_PIECE) return;
+    const Bitboard fromTo = bb::squareBB(from) | bb::squareBB(to);
+    byType_[code % 6] ^= fromTo;
+    byColor_[code / 6] ^= fromTo;
+    mailbox_[to] = code;
+    mailbox_[from] = NO_PIECE;
+    const auto &keys = Zobrist::KEYS.pieces[code / 6][code % 6];
+    key_ ^= keys[from] ^ keys[to];
+    if (code % 6 == static_cast<int>(PieceType::Pawn)) pawnKey_ ^= keys[from] ^ keys[to];
+    const auto &scores = Psqt::SCORES[code / 6][code % 6];
+    psq_ -= scores[from];
+    psq_ += scores[to];
+}
+
+void Board::clear() noexcept {
+    byType_.fill(0);
+    byColor_.fill(0);
+    mailbox_.fill(NO_PIECE);
+    key_ = 0;
+    pawnKey_ = 0;
+    psq_ = {};
+    phase_ = 0;
+}
 
-    board_[7][0] = Piece(PieceType::Rook, Color::Black);
-    board_[7][1] = Piece(PieceType::Knight, Color::Black);
-    board_[7][2] = Piece(PieceType::Bishop, Color::Black);
-    board_[7][3] = Piece(PieceType::Queen, Color::Black);
-    board_[7][4] = Piece(PieceType::King, Color::Black);
-    board_[7][5] = Piece(PieceType::Bishop, Color::Black);
-    board_[7][6] = Piece(PieceType::Knight, Color::Black);
-    board_[7][7] = Piece(PieceType::Rook, Color::Black);
+void Board::initialize() {
+    clear();
+
+    static constexpr PieceType backRank[SIZE] = {
+        PieceType::Rook, PieceType::Knight, PieceType::Bishop, PieceType::Queen,
+        PieceType::King, PieceType::Bishop, PieceType::Knight, PieceType::Rook
+    };
     for (int col = 0; col < SIZE; ++col) {
-        board_[6][col] = Piece(PieceType::Pawn, Color::Black);
+        putPiece(bb::square(0, col), Piece(backRank[col], Color::White));
+        putPiece(bb::square(1, col), Piece(PieceType::Pawn, Color::White));
+        putPiece(bb::square(6, col), Piece(PieceType::Pawn, Color::Black));
+        putPiece(bb::square(7, col), Piece(backRank[col], Color::Black));
     }
 }
 
-void Board::applyMove(const Move& move) {
+std::optional<Piece> Board::applyMove(const Move& move) {
     if (!isInside(move.fromRow, move.fromCol) || !isInside(move.toRow, move.toCol)) {
-        return;
+        return std::nullopt;
     }
-    auto movingOpt = board_[move.fromRow][move.fromCol];
-    if (!movingOpt) return;
+    return applyMove(PackedMove(move));
+}
+
+std::optional<Piece> Board::applyMove(PackedMove move) noexcept {
+    const int from = move.from();
+    const int to = move.to();
+    auto movingOpt = pieceOn(from);
+    if (!movingOpt) return std::nullopt;
     Piece moving = *movingOpt;
 
-    if (move.isCastling && moving.type() == PieceType::King) {
-        int row = move.fromRow;
-        if (move.toCol == 6) {
-            board_[row][5] = board_[row][7];
-            board_[row][7].reset();
-        } else if (move.toCol == 2) {
-            board_[row][3] = board_[row][0];
-            board_[row][0].reset();
+    if (move.isCastling() && moving.type() == PieceType::King) {
+        int row = bb::rowOf(from);
+        if (bb::colOf(to) == 6) {
+            movePiece(bb::square(row, 7), bb::square(row, 5));
+        } else if (bb::colOf(to) == 2) {
+            movePiece(bb::square(row, 0), bb::square(row, 3));
         }
     }
 
-    if (move.isEnPassant && moving.type() == PieceType::Pawn) {
-        board_[move.fromRow][move.toCol].reset();
+    std::optional<Piece> captured;
+    if (move.isEnPassant() && moving.type() == PieceType::Pawn) {
+        const int capSq = bb::square(bb::rowOf(from), bb::colOf(to));
+        captured = pieceOn(capSq);
+        removePiece(capSq);
+    } else {
+        captured = pieceOn(to);
+        removePiece(to);
     }
 
-    if (moving.type() == PieceType::Pawn && move.promotion) {
-        board_[move.toRow][move.toCol] = Piece(*move.promotion, moving.color());
+    if (moving.type() == PieceType::Pawn && move.isPromotion()) {
+        removePiece(from);
+        putPiece(to, Piece(move.promotionType(), moving.color()));
     } else {
-        board_[move.toRow][move.toCol] = movingOpt;
+        movePiece(from, to);
     }
+    return captured;
+}
+
+void Board::undoMove(const Move &move, const std::optional<Piece> &captured) {
+    undoMove(PackedMove(move), captured);
+}
+
+void Board::undoMove(PackedMove move, const std::optional<Piece> &captured) noexcept {
+    const int from = move.from();
+    const int to = move.to();
+    auto movedOpt = pieceOn(to);
+    if (!movedOpt) return;
 
-    board_[move.fromRow][move.fromCol].reset();
+    if (move.isPromotion()) {
+        removePiece(to);
+        putPiece(from, Piece(PieceType::Pawn, movedOpt->color()));
+    } else {
+        movePiece(to, from);
+    }
+
+    if (captured) {
+        putPiece(move.isEnPassant() ? bb::square(bb::rowOf(from), bb::colOf(to)) : to, *captured);
+    }
+
+    if (move.isCastling() && movedOpt->type() == PieceType::King) {
+        int row = bb::rowOf(from);
+        if (bb::colOf(to) == 6) {
+            movePiece(bb::square(row, 5), bb::square(row, 7));
+        } else if (bb::colOf(to) == 2) {
+            movePiece(bb::square(row, 3), bb::square(row, 0));
+        }
+    }
 }
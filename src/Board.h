@@ -2,9 +2,13 @@
 #define BOARD_H
 
 #include <array>
+#include <cstdint>
 #include <optional>
+#include "Bitboard.h"
 #include "Piece.h"
 #include "Move.h"
+#include "PackedMove.h"
+#include "Psqt.h"
 
 class Board {
 public:
@@ -18,18 +22,76 @@ public:
 
     ~Board() = default;
 
-    const std::optional<Piece> &pieceAt(int row, int col) const;
+    [[nodiscard]] std::optional<Piece> pieceAt(int row, int col) const noexcept;
 
-    std::optional<Piece> &pieceAt(int row, int col);
+    [[nodiscard]] std::optional<Piece> pieceOn(int sq) const noexcept;
+
+    void setPiece(int row, int col, const std::optional<Piece> &piece);
+
+    void clear() noexcept;
 
     void initialize();
 
-    void applyMove(const Move &move);
+    std::optional<Piece> applyMove(const Move &move);
+
+    std::optional<Piece> applyMove(PackedMove move) noexcept;
+
+    void undoMove(const Move &move, const std::optional<Piece> &captured);
+
+    void undoMove(PackedMove move, const std::optional<Piece> &captured) noexcept;
 
     bool isInside(int row, int col) const noexcept;
 
+    [[nodiscard]] Bitboard pieces(PieceType type) const noexcept {
+        return byType_[static_cast<int>(type)];
+    }
+
+    [[nodiscard]] Bitboard pieces(Color color) const noexcept {
+        return byColor_[static_cast<int>(color)];
+    }
+
+    [[nodiscard]] Bitboard pieces(Color color, PieceType type) const noexcept {
+        return byColor_[static_cast<int>(color)] & byType_[static_cast<int>(type)];
+    }
+
+    [[nodiscard]] Bitboard occupied() const noexcept {
+        return byColor_[0] | byColor_[1];
+    }
+
+    [[nodiscard]] bool isEmpty(int sq) const noexcept { return mailbox_[sq] == NO_PIECE; }
+
+    [[nodiscard]] int kingSquare(Color color) const noexcept;
+
+    [[nodiscard]] std::uint64_t key() const noexcept { return key_; }
+
+    // Zobrist key of the pawns alone, for caching pawn-structure terms.
+    [[nodiscard]] std::uint64_t pawnKey() const noexcept { return pawnKey_; }
+
+    // Material + piece-square sum from White's side and the remaining non-pawn phase, both incremental.
+    [[nodiscard]] Psqt::Score psq() const noexcept { return psq_; }
+
+    [[nodiscard]] int phase() const noexcept { return phase_; }
+
+    void putPiece(int sq, Piece piece) noexcept;
+
+    void removePiece(int sq) noexcept;
+
+    void movePiece(int from, int to) noexcept;
+
 private:
-    std::array<std::array<std::optional<Piece>, SIZE>, SIZE> board_;
+    static constexpr std::uint8_t NO_PIECE = 12;
+
+    static std::uint8_t encode(Piece piece) noexcept {
+        return static_cast<std::uint8_t>(static_cast<int>(piece.color()) * 6 + static_cast<int>(piece.type()));
+    }
+
+    std::array<Bitboard, 6> byType_;
+    std::array<Bitboard, 2> byColor_;
+    std::array<std::uint8_t, SIZE * SIZE> mailbox_;
+    std::uint64_t key_;
+    std::uint64_t pawnKey_;
+    Psqt::Score psq_;
+    int phase_;
 };
 
 #endif // BOARD_H
@@ -1,20 +1,23 @@
 #include "ChessBoardWidget.h"
 #include "MoveGen.h"
+#include "San.h"
+#include "engine/EnginePool.h"
 #include <QPainter>
 #include <QtSvg/QSvgRenderer>
 #include <QMouseEvent>
 #include <QMessageBox>
 
-
 ChessBoardWidget::ChessBoardWidget(QWidget *parent)
     : QWidget(parent)
+      , engine_(EnginePool::instance().acquire())
       , sideToMove_(Color::White)
       , animating_(false)
       , animProgress_(0.0)
       , animation_(new QPropertyAnimation(this, "animationProgress", this))
       , checkTimer_(new QTimer(this))
       , flashOn_(false)
-      , flashCount_(0) {
+      , flashCount_(0)
+      , clockTimer_(new QTimer(this)) {
     setMouseTracking(true);
     setFocusPolicy(Qt::StrongFocus);
     loadPixmaps();
@@ -25,23 +28,27 @@ ChessBoardWidget::ChessBoardWidget(QWidget *parent)
     connect(animation_, &QPropertyAnimation::finished,
             this, &ChessBoardWidget::onAnimationFinished);
 
-    connect(&engine_, &StockfishClient::engineReady,
+    connect(engine_, &ChessEngine::engineReady,
             this, &ChessBoardWidget::onEngineReady);
-    connect(&engine_, &StockfishClient::bestMove,
+    connect(engine_, &ChessEngine::bestMove,
             this, &ChessBoardWidget::onEngineBestMove);
-    connect(&engine_, &StockfishClient::errorText,
+    connect(engine_, &ChessEngine::errorText,
             this, &ChessBoardWidget::onEngineError);
 
-    connect(&engine_, &StockfishClient::info, this, [](const QString &s) {
+    connect(engine_, &ChessEngine::info, this, [](const QString &s) {
         // qDebug() << "[sf]" << s;
     });
 
     checkTimer_->setInterval(200);
     connect(checkTimer_, &QTimer::timeout, this, &ChessBoardWidget::onCheckFlash);
+
+    clockTimer_->setInterval(100);
+    connect(clockTimer_, &QTimer::timeout, this, &ChessBoardWidget::onClockTick);
 }
 
 ChessBoardWidget::~ChessBoardWidget() {
     delete animation_;
+    EnginePool::instance().release(engine_);
 }
 
 void ChessBoardWidget::newGame() {
@@ -50,6 +57,8 @@ void ChessBoardWidget::newGame() {
     qDebug() << "[mode] vsEngine=" << gameState_.playingEngine()
             << "engineSide=" << (gameState_.engineSide() == Color::White ? "W" : "B");
     checkTimer_->stop();
+    stopPondering();
+    ponderMove_.clear();
 
     const bool vsEngine = gameState_.playingEngine();
     const bool engineIsWhite = gameState_.engineSide() == Color::White;
@@ -63,6 +72,7 @@ void ChessBoardWidget::newGame() {
     flashCount_ = 0;
 
     gameState_ = GameState();
+    viewState_.reset();
 
     gameState_.setPlayingEngine(vsEngine, engineIsWhite);
     flipBoard_ = (gameState_.playingEngine() && gameState_.engineSide() == Color::White);
@@ -73,12 +83,14 @@ void ChessBoardWidget::newGame() {
     update();
     updateInputLock();
     emit gameReset();
+    emit shownPositionChanged();
+    resetClock();
 
     if (gameState_.playingEngine()) {
-        if (!engine_.isRunning())
-            engine_.start("/usr/bin/stockfish");
-        engine_.newGame();
-        engine_.setDifficultyElo(elo, true);
+        if (!engine_->isRunning())
+            engine_->start(EnginePool::enginePath());
+        engine_->newGame();
+        engine_->setDifficultyElo(elo, true);
         if ((engineIsWhite && sideToMove_ == Color::White) ||
             (!engineIsWhite && sideToMove_ == Color::Black)) {
             requestEngineMove();
@@ -93,10 +105,12 @@ bool ChessBoardWidget::canUndo() const {
 void ChessBoardWidget::undoMove() {
     if (animating_) return;
     if (gameState_.undoMove()) {
+        viewState_.reset();
         sideToMove_ = gameState_.sideToMove();
         selectedCell_.reset();
         legalMoves_.clear();
         update();
+        emit shownPositionChanged();
     }
 }
 
@@ -127,6 +141,7 @@ void ChessBoardWidget::mousePressEvent(QMouseEvent *event) {\
     }
     if (animating_) return;
     if (gameOver_) return;
+    if (viewState_) return;
     int row, col;
     if (!pixelToCell(event->pos(), &row, &col)) return;
     const Board &board = gameState_.board();
@@ -134,17 +149,13 @@ void ChessBoardWidget::mousePressEvent(QMouseEvent *event) {\
         auto opt = board.pieceAt(row, col);
         if (opt && opt->color() == sideToMove_) {
             selectedCell_ = QPoint(row, col);
-            legalMoves_.clear();
-            auto all = MoveGenerator::generateLegal(gameState_);
-            for (const auto &m: all) {
-                if (m.fromRow == row && m.fromCol == col)
-                    legalMoves_.push_back(m);
-            }
+            MoveGenerator::generateLegal(gameState_, row, col, legalMoves_);
         }
     } else {
-        for (const auto &m: legalMoves_) {
-            if (m.toRow == row && m.toCol == col) {
-                animateMove(m);
+        for (PackedMove m: legalMoves_) {
+            if (m.toRow() == row && m.toCol() == col) {
+                if (chargeClock(sideToMove_))
+                    animateMove(m.toMove());
                 break;
             }
         }
@@ -155,6 +166,8 @@ void ChessBoardWidget::mousePressEvent(QMouseEvent *event) {\
 }
 
 void ChessBoardWidget::animateMove(const Move &move) {
+    // The animation is drawn over the live position.
+    if (viewState_) setViewPly(static_cast<int>(gameState_.history().size()));
     animating_ = true;
     updateInputLock();
     currentMove_ = move;
@@ -194,8 +207,10 @@ void ChessBoardWidget::onAnimationFinished() {
     animProgress_ = 0;
     currentMove_.reset();
     emit moveMade(san);
+    emit shownPositionChanged();
     update();
-    auto nextMoves = MoveGenerator::generateLegal(gameState_);
+    MoveList nextMoves;
+    MoveGenerator::generateLegal(gameState_, nextMoves);
     if (nextMoves.empty()) {
         bool inCheck = MoveGenerator::isInCheck(gameState_.board(), sideToMove_);
         if (inCheck) {
@@ -220,10 +235,13 @@ void ChessBoardWidget::onAnimationFinished() {
             flashCount_ = 0;
             checkTimer_->start();
         }
+        turnTimer_.restart();
         if (gameState_.playingEngine()) {
             Color engineColor = gameState_.engineSide();
             if (engineColor == sideToMove_) {
                 requestEngineMove();
+            } else {
+                startPondering();
             }
         }
     }
@@ -258,7 +276,7 @@ void ChessBoardWidget::paintEvent(QPaintEvent *) {
         }
     }
     drawCoordinates(painter, xOffset, yOffset, cellSize);
-    if (flashOn_) {
+    if (flashOn_ && !viewState_) {
         int kr = -1, kc = -1;
         for (int r = 0; r < Board::SIZE; ++r) {
             for (int c = 0; c < Board::SIZE; ++c) {
@@ -292,15 +310,15 @@ void ChessBoardWidget::paintEvent(QPaintEvent *) {
     }
 
     if (!animating_) {
-        for (const auto &m: legalMoves_) {
-            int tr = m.toRow, tc = m.toCol;
+        for (PackedMove m: legalMoves_) {
+            int tr = m.toRow(), tc = m.toCol();
             QRect cellRect(
                 xOffset + tc * cellSize,
                 yOffset + toScreenRow(tr) * cellSize,
                 cellSize,
                 cellSize
             );
-            if (gameState_.board().pieceAt(tr, tc).has_value() || m.isEnPassant) {
+            if (gameState_.board().pieceAt(tr, tc).has_value() || m.isEnPassant()) {
                 painter.setBrush(Qt::NoBrush);
                 painter.setPen(QPen(QColor(128, 128, 128, 180), 4));
                 QRect inner = cellRect.marginsRemoved(QMargins(4, 4, 4, 4));
@@ -320,7 +338,7 @@ void ChessBoardWidget::paintEvent(QPaintEvent *) {
 
     for (int r = 0; r < rows; ++r) {
         for (int c = 0; c < cols; ++c) {
-            auto opt = gameState_.board().pieceAt(r, c);
+            auto opt = shownPosition().board().pieceAt(r, c);
             if (!opt) continue;
             if (animating_ && currentMove_) {
                 if (r == currentMove_->fromRow && c == currentMove_->fromCol) continue;
@@ -364,51 +382,49 @@ void ChessBoardWidget::loadPixmaps() {
     }
 }
 
-static QString pieceLetter(PieceType type) {
-    switch (type) {
-        case PieceType::King: return "K";
-        case PieceType::Queen: return "Q";
-        case PieceType::Rook: return "R";
-        case PieceType::Bishop: return "B";
-        case PieceType::Knight: return "N";
-        case PieceType::Pawn: return "";
-    }
-    return "";
+QString ChessBoardWidget::moveToSan(const GameState &state, const Move &move) {
+    return QString::fromStdString(San::fromMove(state, PackedMove(move)));
 }
 
-QString ChessBoardWidget::moveToSan(const GameState &state, const Move &move) {
-    const Board &board = state.board();
-    auto movingOpt = board.pieceAt(move.fromRow, move.fromCol);
-    if (!movingOpt) return {};
-    const Piece moving = *movingOpt;
-    if (move.isCastling) {
-        return move.toCol == 6 ? QStringLiteral("O-O") : QStringLiteral("O-O-O");
-    }
-    bool capture = move.isEnPassant || board.pieceAt(move.toRow, move.toCol).has_value();
-    QString san;
-    QString piece = pieceLetter(moving.type());
-    if (!piece.isEmpty()) san += piece;
-    else if (capture) san += QChar('a' + move.fromCol);
-    if (capture) san += 'x';
-    san += QChar('a' + move.toCol);
-    san += QChar('1' + move.toRow);
-    if (move.promotion) {
-        san += '=';
-        san += pieceLetter(*move.promotion);
-    }
-    GameState temp = state;
-    temp.applyMove(move);
-    if (MoveGenerator::isInCheck(temp.board(), temp.sideToMove())) {
-        san += '+';
+Color ChessBoardWidget::sideToMove() const noexcept { return sideToMove_; }
+
+void ChessBoardWidget::setViewPly(int ply) {
+    const int live = static_cast<int>(gameState_.history().size());
+    ply = qBound(0, ply, live);
+    if (ply == viewPly()) return;
+    if (ply == live) {
+        viewState_.reset();
+    } else {
+        GameState state;
+        for (int i = 0; i < ply; ++i) state.applyMove(gameState_.history()[i]);
+        viewState_ = state;
+        viewPly_ = ply;
+        selectedCell_.reset();
+        legalMoves_.clear();
     }
-    return san;
+    update();
+    emit shownPositionChanged();
 }
 
-Color ChessBoardWidget::sideToMove() const noexcept { return sideToMove_; }
+void ChessBoardWidget::stepView(int delta) {
+    setViewPly(viewPly() + delta);
+}
+
+int ChessBoardWidget::viewPly() const {
+    return viewState_ ? viewPly_ : static_cast<int>(gameState_.history().size());
+}
+
+const GameState &ChessBoardWidget::shownPosition() const {
+    return viewState_ ? *viewState_ : gameState_;
+}
+
+QStringList ChessBoardWidget::shownMovesAsUci() const {
+    return historyAsUci().mid(0, viewPly());
+}
 
 QStringList ChessBoardWidget::historyAsUci() const {
     QStringList lst;
-    for (const Move &m: gameState_.history()) {
+    for (const PackedMove &m: gameState_.history()) {
         lst << QString::fromStdString(m.toUCI());
     }
     return lst;
@@ -422,16 +438,66 @@ void ChessBoardWidget::requestEngineMove() {
     auto engineColor = gameState_.engineSide();
     if (engineColor != sideToMove_) return;
     engineThinking_ = true;
-    QString fen = QString::fromStdString(gameState_.fenFull());
-    engine_.setPositionFEN(fen);
-    engine_.goMovetime(3000); // 3 сек на ход
+    if (pondering_) {
+        pondering_ = false;
+        const auto &history = gameState_.history();
+        if (!history.empty() && QString::fromStdString(history.back().toUCI()) == ponderMove_) {
+            // The engine has been searching this very position on our time.
+            engine_->ponderHit();
+            return;
+        }
+        engine_->stop();
+    }
+    // The move list rather than a FEN gives the engine the game history for repetition detection.
+    engine_->setPositionFromStartpos(historyAsUci());
+    if (!clockEnabled()) {
+        engine_->goMovetime(3000); // 3 сек на ход
+        return;
+    }
+    sendEngineClock(false);
 }
 
-void ChessBoardWidget::onEngineBestMove(const QString &uci, const QString &) {
+void ChessBoardWidget::sendEngineClock(bool ponder) {
+    const int moves = timeControl_.movesToGo;
+    const int side = static_cast<int>(gameState_.engineSide());
+    const int movesToGo = moves > 0 ? moves - movesMade_[side] % moves : 0;
+    const int wtime = static_cast<int>(qMax<qint64>(1, remainingMs(Color::White)));
+    const int btime = static_cast<int>(qMax<qint64>(1, remainingMs(Color::Black)));
+    const int inc = static_cast<int>(timeControl_.incrementMs);
+    if (ponder)
+        engine_->goPonder(wtime, btime, inc, inc, movesToGo);
+    else
+        engine_->goClock(wtime, btime, inc, inc, movesToGo);
+}
+
+// Only timed games ponder: with a fixed movetime there is no clock for the saved time to go to.
+void ChessBoardWidget::startPondering() {
+    if (!clockEnabled() || ponderMove_.isEmpty() || engineThinking_ || pondering_) return;
+    if (!Move::fromUCIInPosition(ponderMove_.toStdString(), gameState_)) {
+        ponderMove_.clear();
+        return;
+    }
+    QStringList moves = historyAsUci();
+    moves << ponderMove_;
+    engine_->setPositionFromStartpos(moves);
+    sendEngineClock(true);
+    pondering_ = true;
+}
+
+void ChessBoardWidget::stopPondering() {
+    if (!pondering_) return;
+    pondering_ = false;
+    engine_->stop();
+}
+
+void ChessBoardWidget::onEngineBestMove(const QString &uci, const QString &ponder) {
+    if (!gameState_.playingEngine()) return;
     engineThinking_ = false;
+    ponderMove_.clear();
     qDebug() << "[engine] bestmove" << uci;
     if (uci.isEmpty() || uci == "none" || uci == "(none)") {
-        auto nextMoves = MoveGenerator::generateLegal(gameState_);
+        MoveList nextMoves;
+        MoveGenerator::generateLegal(gameState_, nextMoves);
         bool inCheck = MoveGenerator::isInCheck(gameState_.board(), sideToMove_);
         if (nextMoves.empty()) {
             QMessageBox::information(this, tr("Мат/Пат"), inCheck ? tr("Мат!") : tr("Пат!"));
@@ -451,9 +517,11 @@ void ChessBoardWidget::onEngineBestMove(const QString &uci, const QString &) {
     Move m = *parsed;
 
     bool ok = false;
-    for (const auto &lm: MoveGenerator::generateLegal(gameState_)) {
-        if (lm.sameSquaresAndPromo(m)) {
-            m = lm;
+    MoveList legal;
+    MoveGenerator::generateLegal(gameState_, m.fromRow, m.fromCol, legal);
+    for (PackedMove lm: legal) {
+        if (lm.toMove().sameSquaresAndPromo(m)) {
+            m = lm.toMove();
             ok = true;
             break;
         }
@@ -463,6 +531,8 @@ void ChessBoardWidget::onEngineBestMove(const QString &uci, const QString &) {
         return;
     }
 
+    if (!chargeClock(sideToMove_)) return;
+    ponderMove_ = ponder;
     animateMove(m);
 }
 
@@ -485,13 +555,75 @@ void ChessBoardWidget::setPlayVsEngine(bool enabled, bool engineIsWhite, int elo
         engineReady_ = false;
         pendingEngineMove_ = false;
         engineThinking_ = false;
-        engine_.quit();
+        // The engine stays leased and warm in case the board switches back.
+        stopPondering();
         userInputLocked_ = false;
         setCursor(Qt::ArrowCursor);
     }
     newGame();
 }
 
+void ChessBoardWidget::setTimeControl(const TimeControl &timeControl) {
+    timeControl_ = timeControl;
+}
+
+qint64 ChessBoardWidget::remainingMs(Color side) const {
+    qint64 remaining = clockMs_[static_cast<int>(side)];
+    // The timer runs only while the side to move is thinking; it is invalid during animations.
+    if (side == sideToMove_ && turnTimer_.isValid()) remaining -= turnTimer_.elapsed();
+    return remaining;
+}
+
+bool ChessBoardWidget::clockEnabled() const {
+    return timeControl_.baseMs > 0;
+}
+
+void ChessBoardWidget::resetClock() {
+    clockMs_[0] = clockMs_[1] = timeControl_.baseMs;
+    movesMade_[0] = movesMade_[1] = 0;
+    turnTimer_.restart();
+    if (clockEnabled()) clockTimer_->start();
+    else clockTimer_->stop();
+    emit clockChanged(clockMs_[0], clockMs_[1]);
+}
+
+// Stops the mover's clock and credits increment and, at a control, the next period.
+// Returns false when the move came too late and the game is lost on time.
+bool ChessBoardWidget::chargeClock(Color side) {
+    if (!clockEnabled()) return true;
+    const int i = static_cast<int>(side);
+    clockMs_[i] = remainingMs(side);
+    turnTimer_.invalidate();
+    if (clockMs_[i] <= 0) {
+        loseOnTime(side);
+        return false;
+    }
+    clockMs_[i] += timeControl_.incrementMs;
+    ++movesMade_[i];
+    if (timeControl_.movesToGo > 0 && movesMade_[i] % timeControl_.movesToGo == 0)
+        clockMs_[i] += timeControl_.baseMs;
+    emit clockChanged(clockMs_[0], clockMs_[1]);
+    return true;
+}
+
+void ChessBoardWidget::onClockTick() {
+    if (!clockEnabled() || gameOver_) return;
+    emit clockChanged(remainingMs(Color::White), remainingMs(Color::Black));
+    // A thinking engine is judged when its move arrives, so a late reply is not applied to the next game.
+    if (!engineThinking_ && turnTimer_.isValid() && remainingMs(sideToMove_) <= 0)
+        loseOnTime(sideToMove_);
+}
+
+void ChessBoardWidget::loseOnTime(Color side) {
+    clockTimer_->stop();
+    const Color winner = side == Color::White ? Color::Black : Color::White;
+    QMessageBox::information(this, tr("Время"),
+                             tr("Время вышло! Победили %1").arg(
+                                 winner == Color::White ? tr("Белые") : tr("Чёрные")));
+    gameOver_ = true;
+    newGame();
+}
+
 void ChessBoardWidget::updateInputLock() {
     bool lock = animating_ || gameOver_;
     if (gameState_.playingEngine() && sideToMove_ == gameState_.engineSide()) {
@@ -8,30 +8,54 @@
 #include <vector>
 #include <QPropertyAnimation>
 #include <QTimer>
+#include <QElapsedTimer>
 #include <QString>
 #include "GameState.h"
-#include "engine/StockFishClient.h"
+#include "MoveList.h"
+#include "engine/ChessEngine.h"
 
 class ChessBoardWidget : public QWidget {
     Q_OBJECT
     Q_PROPERTY(qreal animationProgress READ animationProgress WRITE setAnimationProgress)
 
 public:
+    // baseMs 0 means an untimed game; movesToGo 0 means the base time covers the whole game.
+    struct TimeControl {
+        qint64 baseMs = 0;
+        qint64 incrementMs = 0;
+        int movesToGo = 0;
+    };
+
     explicit ChessBoardWidget(QWidget *parent = nullptr);
 
     ~ChessBoardWidget() override;
 
     void newGame();
     void setPlayVsEngine(bool enabled, bool engineIsWhite, int elo);
+    // Takes effect from the next newGame().
+    void setTimeControl(const TimeControl &timeControl);
+    [[nodiscard]] qint64 remainingMs(Color side) const;
     [[nodiscard]] bool canUndo() const;
 
     void undoMove();
 
     [[nodiscard]] Color sideToMove() const noexcept;
 
+    // Shows the position after the first ply moves of the game without touching the game itself;
+    // a ply at or beyond the end of the history returns to the live position.
+    void setViewPly(int ply);
+    void stepView(int delta);
+    [[nodiscard]] int viewPly() const;
+    [[nodiscard]] const GameState &shownPosition() const;
+    [[nodiscard]] QStringList shownMovesAsUci() const;
+
+    static QString moveToSan(const GameState &state, const Move &move);
+
 signals:
     void moveMade(const QString &san);
     void gameReset();
+    void clockChanged(qint64 whiteMs, qint64 blackMs);
+    void shownPositionChanged();
 
 protected:
     void paintEvent(QPaintEvent *event) override;
@@ -49,6 +73,8 @@ private slots:
 
     void onCheckFlash();
 
+    void onClockTick();
+
 private:
     bool pixelToCell(const QPoint &pt, int *row, int *col) const;
 
@@ -58,20 +84,33 @@ private:
 
     void animateMove(const Move &move);
     void requestEngineMove();
+    void sendEngineClock(bool ponder);
+    void startPondering();
+    void stopPondering();
+    [[nodiscard]] bool clockEnabled() const;
+    void resetClock();
+    bool chargeClock(Color side);
+    void loseOnTime(Color side);
     QStringList historyAsUci() const;
     bool userInputLocked_ = false;
     void updateInputLock();
 
     GameState gameState_;
-    StockfishClient engine_;
+    // Set while an earlier position of the game is shown.
+    std::optional<GameState> viewState_;
+    int viewPly_ = 0;
+    ChessEngine *engine_;
     int engineElo_ = 1600;
     bool engineThinking_ = false;
     bool engineReady_ = false;
     bool pendingEngineMove_ = false;
+    // The reply the engine expects from us, and whether it is currently searching the position after it.
+    QString ponderMove_;
+    bool pondering_ = false;
     bool gameOver_;
     Color sideToMove_;
     std::optional<QPoint> selectedCell_;
-    std::vector<Move> legalMoves_;
+    MoveList legalMoves_;
 
     bool animating_;
     std::optional<Move> currentMove_;
@@ -84,12 +123,16 @@ private:
     int flashCount_;
     bool flipBoard_ = false;
 
+    TimeControl timeControl_;
+    qint64 clockMs_[2] = {0, 0};
+    int movesMade_[2] = {0, 0};
+    QElapsedTimer turnTimer_;
+    QTimer *clockTimer_;
+
     QPixmap piecePixmaps_[6][2];
 
     void loadPixmaps();
 
-    static QString moveToSan(const GameState &state, const Move &move);
-
     inline int toScreenRow(int r) const {
         return flipBoard_ ? r : (Board::SIZE - 1 - r);
     }
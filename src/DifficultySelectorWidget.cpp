@@ -27,12 +27,38 @@ DifficultySelectorWidget::DifficultySelectorWidget(QWidget* parent)
     colorRow->addWidget(randomBtn_);
     colorRow->addStretch();
 
+    // Минуты на партию, секунды прибавки и ходы до контроля (0 — на всю партию).
+    // Без часов движок думает фиксированное время на ход, как раньше.
+    struct Preset { const char* name; int minutes; int incrementSec; int movesToGo; };
+    static const Preset PRESETS[] = {
+        {"Без часов", 0, 0, 0},
+        {"Пуля 1+0", 1, 0, 0},
+        {"Блиц 3+2", 3, 2, 0},
+        {"Блиц 5+0", 5, 0, 0},
+        {"Рапид 10+5", 10, 5, 0},
+        {"Классика 40 ходов / 30 мин", 30, 0, 40},
+    };
+    auto* timeLabel = new QLabel("Контроль:", this);
+    timeControlBox_ = new QComboBox(this);
+    for (const Preset& preset : PRESETS) {
+        timeControlBox_->addItem(preset.name,
+                                 QVariantList{preset.minutes, preset.incrementSec, preset.movesToGo});
+    }
+    timeControlBox_->setCurrentIndex(0);
+
+    auto* timeRow = new QHBoxLayout();
+    timeRow->addWidget(timeLabel);
+    timeRow->addSpacing(8);
+    timeRow->addWidget(timeControlBox_);
+    timeRow->addStretch();
+
     easyButton_ = new QPushButton("Лёгкий", this);
     mediumButton_ = new QPushButton("Средний", this);
     hardButton_ = new QPushButton("Сложный", this);
 
     auto* layout = new QVBoxLayout(this);
     layout->addLayout(colorRow);
+    layout->addLayout(timeRow);
     layout->addSpacing(6);
     layout->addWidget(easyButton_);
     layout->addWidget(mediumButton_);
@@ -52,7 +78,7 @@ void DifficultySelectorWidget::onEasyClicked() {
     const bool engineWhite = decideEngineIsWhite();
     const QString color = (engineWhite ? "чёрными" : "белыми");
     QMessageBox::information(this, "Бот", "Игра с ботом (легкий уровень), вы играете " + color);
-    auto* window = new MenuWindow(true, 1200, engineWhite);
+    auto* window = new MenuWindow(true, 1200, engineWhite, selectedTimeControl());
     window->setAttribute(Qt::WA_DeleteOnClose);
     window->show();
     close();
@@ -62,7 +88,7 @@ void DifficultySelectorWidget::onMediumClicked() {
     const bool engineWhite = decideEngineIsWhite();
     const QString color = (engineWhite ? "чёрными" : "белыми");
     QMessageBox::information(this, "Бот", "Игра с ботом (легкий уровень), вы играете " + color);
-    auto* window = new MenuWindow(true, 1600, engineWhite);
+    auto* window = new MenuWindow(true, 1600, engineWhite, selectedTimeControl());
     window->setAttribute(Qt::WA_DeleteOnClose);
     window->show();
     close();
@@ -72,7 +98,7 @@ void DifficultySelectorWidget::onHardClicked() {
     const bool engineWhite = decideEngineIsWhite();
     const QString color = (engineWhite ? "чёрными" : "белыми");
     QMessageBox::information(this, "Бот", "Игра с ботом (легкий уровень), вы играете " + color);
-    auto* window = new MenuWindow(true, 2000,engineWhite);
+    auto* window = new MenuWindow(true, 2000, engineWhite, selectedTimeControl());
     window->setAttribute(Qt::WA_DeleteOnClose);
     window->show();
     close();
@@ -90,4 +116,12 @@ bool DifficultySelectorWidget::decideEngineIsWhite() const {
             return engineWhite;
         }
     }
-}
\ No newline at end of file
+}
+ChessBoardWidget::TimeControl DifficultySelectorWidget::selectedTimeControl() const {
+    const QVariantList preset = timeControlBox_->currentData().toList();
+    ChessBoardWidget::TimeControl timeControl;
+    timeControl.baseMs = preset.value(0).toLongLong() * 60 * 1000;
+    timeControl.incrementMs = preset.value(1).toLongLong() * 1000;
+    timeControl.movesToGo = preset.value(2).toInt();
+    return timeControl;
+}
@@ -5,6 +5,8 @@
 #include <QPushButton>
 #include <QButtonGroup>
 #include <QRadioButton>
+#include <QComboBox>
+#include "ChessBoardWidget.h"
 
 class DifficultySelectorWidget : public QWidget {
     Q_OBJECT
@@ -27,7 +29,10 @@ private:
     QRadioButton* blackBtn_{};
     QRadioButton* randomBtn_{};
 
+    QComboBox* timeControlBox_{};
+
     bool decideEngineIsWhite() const;
+    ChessBoardWidget::TimeControl selectedTimeControl() const;
 };
 
 #endif // DIFFICULTYSELECTORWIDGET_H
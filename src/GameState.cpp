@@ -1,14 +1,76 @@
 #include "GameState.h"
+#include "Zobrist.h"
 
-#include <qstring.h>
+#include <algorithm>
 #include <sstream>
 GameState::GameState()
     : board_(), sideToMove_(Color::White),
-      whiteKingSideCastle_(true), whiteQueenSideCastle_(true),
-      blackKingSideCastle_(true), blackQueenSideCastle_(true),
-      enPassantTarget_(std::nullopt), halfmoveClock_(0) {
-    std::string key = fenFull();
-    repetitionCounts_[key] = 1;
+      playingEngine_(false), engineSide_(Color::Black),
+      castlingRights_(WhiteKingSide | WhiteQueenSide | BlackKingSide | BlackQueenSide),
+      enPassantTarget_(std::nullopt), halfmoveClock_(0), startPly_(0) {
+}
+
+std::optional<GameState> GameState::fromFEN(const std::string &fen) {
+    std::istringstream in(fen);
+    std::string placement, side, castling = "-", ep = "-";
+    int halfmove = 0, fullmove = 1;
+    if (!(in >> placement >> side)) return std::nullopt;
+    in >> castling >> ep >> halfmove >> fullmove;
+
+    GameState state;
+    state.board_.clear();
+    int row = Board::SIZE - 1, col = 0;
+    int kings[2] = {0, 0};
+    for (char ch: placement) {
+        if (ch == '/') {
+            if (col != Board::SIZE || row == 0) return std::nullopt;
+            --row;
+            col = 0;
+        } else if (ch >= '1' && ch <= '8') {
+            col += ch - '0';
+        } else {
+            auto piece = Piece::fromSymbol(ch);
+            if (!piece || col >= Board::SIZE) return std::nullopt;
+            // Move generation steps pawns off the board from the last rank.
+            if (piece->type() == PieceType::Pawn && (row == 0 || row == Board::SIZE - 1)) return std::nullopt;
+            if (piece->type() == PieceType::King) ++kings[static_cast<int>(piece->color())];
+            state.board_.setPiece(row, col++, *piece);
+        }
+        if (col > Board::SIZE) return std::nullopt;
+    }
+    if (row != 0 || col != Board::SIZE) return std::nullopt;
+    if (kings[0] != 1 || kings[1] != 1) return std::nullopt;
+
+    if (side == "w") state.sideToMove_ = Color::White;
+    else if (side == "b") state.sideToMove_ = Color::Black;
+    else return std::nullopt;
+
+    state.castlingRights_ = 0;
+    for (char ch: castling) {
+        switch (ch) {
+            case 'K': state.castlingRights_ |= WhiteKingSide;
+                break;
+            case 'Q': state.castlingRights_ |= WhiteQueenSide;
+                break;
+            case 'k': state.castlingRights_ |= BlackKingSide;
+                break;
+            case 'q': state.castlingRights_ |= BlackQueenSide;
+                break;
+            case '-': break;
+            default: return std::nullopt;
+        }
+    }
+
+    state.enPassantTarget_.reset();
+    if (ep != "-") {
+        if (ep.size() != 2 || ep[0] < 'a' || ep[0] > 'h') return std::nullopt;
+        if (ep[1] != (state.sideToMove_ == Color::White ? '6' : '3')) return std::nullopt;
+        state.enPassantTarget_ = std::make_pair(ep[1] - '1', ep[0] - 'a');
+    }
+
+    state.halfmoveClock_ = std::max(0, halfmove);
+    state.startPly_ = 2 * (std::max(1, fullmove) - 1) + (state.sideToMove_ == Color::Black ? 1 : 0);
+    return state;
 }
 
 const Board &GameState::board() const noexcept { return board_; }
@@ -21,11 +83,11 @@ void GameState::setPlayingEngine(bool enabled, bool engineIsWhite) {
 }
 
 bool GameState::canCastleKingSide(Color color) const noexcept {
-    return (color == Color::White) ? whiteKingSideCastle_ : blackKingSideCastle_;
+    return castlingRights_ & (color == Color::White ? WhiteKingSide : BlackKingSide);
 }
 
 bool GameState::canCastleQueenSide(Color color) const noexcept {
-    return (color == Color::White) ? whiteQueenSideCastle_ : blackQueenSideCastle_;
+    return castlingRights_ & (color == Color::White ? WhiteQueenSide : BlackQueenSide);
 }
 
 std::optional<std::pair<int, int> > GameState::enPassantTarget() const noexcept {
@@ -33,12 +95,37 @@ std::optional<std::pair<int, int> > GameState::enPassantTarget() const noexcept
 }
 
 int GameState::halfmoveClock() const noexcept { return halfmoveClock_; }
-const std::vector<Move> &GameState::history() const noexcept { return history_; }
+const std::vector<PackedMove> &GameState::history() const noexcept { return history_; }
 
+std::uint64_t GameState::key() const noexcept {
+    std::uint64_t k = board_.key() ^ Zobrist::KEYS.castling[castlingRights_];
+    if (sideToMove_ == Color::Black) k ^= Zobrist::KEYS.side;
+    if (enPassantTarget_) k ^= Zobrist::KEYS.enPassantFile[enPassantTarget_->second];
+    return k;
+}
+
+std::uint64_t GameState::pawnKey() const noexcept {
+    return board_.pawnKey();
+}
+
+// Only positions since the last capture or pawn move, with the same side to move, can repeat.
 int GameState::repetitionCount() const noexcept {
-    auto key = fenFull();
-    auto it = repetitionCounts_.find(key);
-    return (it != repetitionCounts_.end() ? it->second : 0);
+    const std::uint64_t current = key();
+    const int reach = std::min<int>(halfmoveClock_, static_cast<int>(keyHistory_.size()));
+    int count = 1;
+    for (int back = 4; back <= reach; back += 2) {
+        if (keyHistory_[keyHistory_.size() - back] == current) ++count;
+    }
+    return count;
+}
+
+bool GameState::isRepetition() const noexcept {
+    const std::uint64_t current = key();
+    const int reach = std::min<int>(halfmoveClock_, static_cast<int>(keyHistory_.size()));
+    for (int back = 4; back <= reach; back += 2) {
+        if (keyHistory_[keyHistory_.size() - back] == current) return true;
+    }
+    return false;
 }
 
 std::string GameState::fenFull() const {
@@ -63,10 +150,10 @@ std::string GameState::fenFull() const {
     oss << ' ' << (sideToMove_ == Color::White ? 'w' : 'b');
     oss << ' ';
     std::string cr;
-    if (whiteKingSideCastle_)  cr += 'K';
-    if (whiteQueenSideCastle_) cr += 'Q';
-    if (blackKingSideCastle_)  cr += 'k';
-    if (blackQueenSideCastle_) cr += 'q';
+    if (castlingRights_ & WhiteKingSide)  cr += 'K';
+    if (castlingRights_ & WhiteQueenSide) cr += 'Q';
+    if (castlingRights_ & BlackKingSide)  cr += 'k';
+    if (castlingRights_ & BlackQueenSide) cr += 'q';
     oss << (cr.empty() ? "-" : cr);
     oss << ' ';
     if (enPassantTarget_) {
@@ -77,87 +164,79 @@ std::string GameState::fenFull() const {
         oss << '-';
     }
     oss << ' ' << halfmoveClock_;
-    int fullmove = 1 + static_cast<int>(history_.size()) / 2;
+    int fullmove = 1 + (startPly_ + static_cast<int>(history_.size())) / 2;
     oss << ' ' << fullmove;
     return oss.str();
 }
 
 void GameState::applyMove(const Move &move) {
-    StateSnapshot snap{
-        board_, sideToMove_,
-        whiteKingSideCastle_, whiteQueenSideCastle_,
-        blackKingSideCastle_, blackQueenSideCastle_,
-        enPassantTarget_, halfmoveClock_,
-        history_, repetitionCounts_
-    };
-    snapshots_.push_back(std::move(snap));
-
-    auto movingOpt = board_.pieceAt(move.fromRow, move.fromCol);
-    if (!movingOpt) return;
-    PieceType pt = movingOpt->type();
-    Color movingColor = movingOpt->color();
-    std::optional<Piece> captured;
-    if (move.isEnPassant) captured = board_.pieceAt(move.fromRow, move.toCol);
-    else captured = board_.pieceAt(move.toRow, move.toCol);
-    bool isCapture = captured.has_value();
-
-    board_.applyMove(move);
-
-    if (pt == PieceType::King) {
-        if (movingColor == Color::White)
-            whiteKingSideCastle_ = whiteQueenSideCastle_ = false;
-        else
-            blackKingSideCastle_ = blackQueenSideCastle_ = false;
-    } else if (pt == PieceType::Rook) {
-        if (movingColor == Color::White) {
-            if (move.fromRow == 0 && move.fromCol == 7) whiteKingSideCastle_ = false;
-            if (move.fromRow == 0 && move.fromCol == 0) whiteQueenSideCastle_ = false;
-        } else {
-            if (move.fromRow == 7 && move.fromCol == 7) blackKingSideCastle_ = false;
-            if (move.fromRow == 7 && move.fromCol == 0) blackQueenSideCastle_ = false;
-        }
+    applyMove(PackedMove(move));
+}
+
+void GameState::applyMove(PackedMove move) {
+    if (!board_.pieceOn(move.from())) return;
+    UndoInfo undo;
+    makeMove(move, undo);
+    undoStack_.push_back(undo);
+    history_.push_back(move);
+}
+
+std::uint8_t GameState::castlingMaskFor(int sq) noexcept {
+    switch (sq) {
+        case bb::square(0, 4): return WhiteKingSide | WhiteQueenSide;
+        case bb::square(0, 7): return WhiteKingSide;
+        case bb::square(0, 0): return WhiteQueenSide;
+        case bb::square(7, 4): return BlackKingSide | BlackQueenSide;
+        case bb::square(7, 7): return BlackKingSide;
+        case bb::square(7, 0): return BlackQueenSide;
+        default: return 0;
     }
-    if (pt == PieceType::Pawn && std::abs(move.toRow - move.fromRow) == 2) {
-        enPassantTarget_ = std::make_pair((move.fromRow + move.toRow) / 2, move.fromCol);
+}
+
+void GameState::makeMove(const Move &move, UndoInfo &undo) {
+    makeMove(PackedMove(move), undo);
+}
+
+void GameState::makeMove(PackedMove move, UndoInfo &undo) {
+    undo.castlingRights = castlingRights_;
+    undo.enPassant = enPassantTarget_;
+    undo.halfmoveClock = halfmoveClock_;
+    keyHistory_.push_back(key());
+
+    const int from = move.from(), to = move.to();
+    const PieceType pt = board_.pieceOn(from)->type();
+    undo.captured = board_.applyMove(move);
+
+    castlingRights_ &= ~(castlingMaskFor(from) | castlingMaskFor(to));
+
+    if (pt == PieceType::Pawn && (to - from == 16 || from - to == 16)) {
+        enPassantTarget_ = std::make_pair(bb::rowOf((from + to) / 2), bb::colOf(from));
     } else {
         enPassantTarget_.reset();
     }
-    if (isCapture && captured->type() == PieceType::Rook) {
-        auto [cr, cc] = move.isEnPassant
-                            ? std::make_pair(move.fromRow, move.toCol)
-                            : std::make_pair(move.toRow, move.toCol);
-        if (captured->color() == Color::White) {
-            if (cr == 0 && cc == 7) whiteKingSideCastle_ = false;
-            if (cr == 0 && cc == 0) whiteQueenSideCastle_ = false;
-        } else {
-            if (cr == 7 && cc == 7) blackKingSideCastle_ = false;
-            if (cr == 7 && cc == 0) blackQueenSideCastle_ = false;
-        }
-    }
-    if (pt == PieceType::Pawn || isCapture) halfmoveClock_ = 0;
+    if (pt == PieceType::Pawn || undo.captured) halfmoveClock_ = 0;
     else ++halfmoveClock_;
 
-    history_.push_back(move);
     sideToMove_ = (sideToMove_ == Color::White ? Color::Black : Color::White);
+}
 
-    std::string key = fenFull();
-    repetitionCounts_[key]++;
+void GameState::unmakeMove(const Move &move, const UndoInfo &undo) {
+    unmakeMove(PackedMove(move), undo);
+}
+
+void GameState::unmakeMove(PackedMove move, const UndoInfo &undo) {
+    sideToMove_ = (sideToMove_ == Color::White ? Color::Black : Color::White);
+    board_.undoMove(move, undo.captured);
+    castlingRights_ = undo.castlingRights;
+    enPassantTarget_ = undo.enPassant;
+    halfmoveClock_ = undo.halfmoveClock;
+    keyHistory_.pop_back();
 }
 
 bool GameState::undoMove() {
-    if (snapshots_.empty()) return false;
-    StateSnapshot snap = std::move(snapshots_.back());
-    snapshots_.pop_back();
-
-    board_ = snap.board;
-    sideToMove_ = snap.side;
-    whiteKingSideCastle_ = snap.wKS;
-    whiteQueenSideCastle_ = snap.wQS;
-    blackKingSideCastle_ = snap.bKS;
-    blackQueenSideCastle_ = snap.bQS;
-    enPassantTarget_ = snap.enPassant;
-    halfmoveClock_ = snap.halfmoveClock;
-    history_ = std::move(snap.history);
-    repetitionCounts_ = std::move(snap.repetitionCounts);
+    if (undoStack_.empty()) return false;
+    unmakeMove(history_.back(), undoStack_.back());
+    undoStack_.pop_back();
+    history_.pop_back();
     return true;
 }
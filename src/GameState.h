@@ -3,18 +3,20 @@
 
 #include "Board.h"
 #include "Move.h"
+#include "PackedMove.h"
 #include "Piece.h"
+#include <cstdint>
 #include <vector>
 #include <optional>
 #include <utility>
-#include <map>
-#include <qstring.h>
 #include <string>
 
 class GameState {
 public:
     GameState();
 
+    static std::optional<GameState> fromFEN(const std::string& fen);
+
     [[nodiscard]] const Board& board() const noexcept;
     [[nodiscard]] Color sideToMove() const noexcept;
     [[nodiscard]] bool playingEngine() const noexcept;
@@ -23,41 +25,54 @@ public:
     [[nodiscard]] bool canCastleQueenSide(Color color) const noexcept;
     [[nodiscard]] std::optional<std::pair<int,int>> enPassantTarget() const noexcept;
     [[nodiscard]] int halfmoveClock() const noexcept;
-    [[nodiscard]] const std::vector<Move>& history() const noexcept;
+    [[nodiscard]] const std::vector<PackedMove>& history() const noexcept;
     void setPlayingEngine(bool enabled, bool engineIsWhite);
     [[nodiscard]] int repetitionCount() const noexcept;
+    [[nodiscard]] bool isRepetition() const noexcept;
+    [[nodiscard]] std::uint64_t key() const noexcept;
+    [[nodiscard]] std::uint64_t pawnKey() const noexcept;
     [[nodiscard]] std::string fenFull() const;
 
 
     void applyMove(const Move& move);
+    void applyMove(PackedMove move);
 
     bool undoMove();
 
+    struct UndoInfo {
+        std::optional<Piece> captured;
+        std::uint8_t castlingRights;
+        std::optional<std::pair<int,int>> enPassant;
+        int halfmoveClock;
+    };
+
+    void makeMove(const Move& move, UndoInfo& undo);
+    void makeMove(PackedMove move, UndoInfo& undo);
+    void unmakeMove(const Move& move, const UndoInfo& undo);
+    void unmakeMove(PackedMove move, const UndoInfo& undo);
+
 private:
+    enum CastlingRight : std::uint8_t {
+        WhiteKingSide = 1,
+        WhiteQueenSide = 2,
+        BlackKingSide = 4,
+        BlackQueenSide = 8
+    };
+
+    static std::uint8_t castlingMaskFor(int sq) noexcept;
+
     Board board_;
     Color sideToMove_;
     bool playingEngine_;
     Color engineSide_;
-    bool whiteKingSideCastle_;
-    bool whiteQueenSideCastle_;
-    bool blackKingSideCastle_;
-    bool blackQueenSideCastle_;
+    std::uint8_t castlingRights_;
     std::optional<std::pair<int,int>> enPassantTarget_;
     int halfmoveClock_;
-    std::vector<Move> history_;
-
-    std::map<std::string,int> repetitionCounts_;
+    int startPly_;
+    std::vector<PackedMove> history_;
+    std::vector<std::uint64_t> keyHistory_;
 
-    struct StateSnapshot {
-        Board board;
-        Color side;
-        bool wKS, wQS, bKS, bQS;
-        std::optional<std::pair<int,int>> enPassant;
-        int halfmoveClock;
-        std::vector<Move> history;
-        std::map<std::string,int> repetitionCounts;
-    };
-    std::vector<StateSnapshot> snapshots_;
+    std::vector<UndoInfo> undoStack_;
 
 };
 
@@ -3,16 +3,24 @@
 #include <QHBoxLayout>
 #include <QMessageBox>
 #include "MainMenuWidget.h"
+#include "engine/EnginePool.h"
 
 MenuWindow::MenuWindow(QWidget* parent)
-    : MenuWindow(false, 1600, false, parent) {}
+    : MenuWindow(false, 1600, false, {}, parent) {}
 
-MenuWindow::MenuWindow(bool vsEngine, int engineElo, bool engineIsWhite, QWidget* parent)
+MenuWindow::MenuWindow(bool vsEngine, int engineElo, bool engineIsWhite,
+                       const ChessBoardWidget::TimeControl& timeControl, QWidget* parent)
     : QWidget(parent)
     , board_(new ChessBoardWidget(this))
     , historyList_(new QListWidget(this))
+    , clockLabel_(new QLabel(this))
     , resignButton_(new QPushButton(tr("Сдаться"), this))
     , returnToMenuButton_(new QPushButton(tr("Меню"), this))
+    , analysisButton_(new QPushButton(tr("Анализ"), this))
+    , analysisLinesBox_(new QSpinBox(this))
+    , prevButton_(new QPushButton(QStringLiteral("◀"), this))
+    , nextButton_(new QPushButton(QStringLiteral("▶"), this))
+    , analysisList_(new QListWidget(this))
     , halfmoveCount_(0)
     , vsEngine_(vsEngine)
     , engineElo_(engineElo)
@@ -65,8 +73,37 @@ MenuWindow::MenuWindow(bool vsEngine, int engineElo, bool engineIsWhite, QWidget
 
     resignButton_->setStyleSheet(buttonStyle);
     returnToMenuButton_->setStyleSheet(buttonStyle);
+    analysisButton_->setStyleSheet(buttonStyle);
+    prevButton_->setStyleSheet(buttonStyle);
+    nextButton_->setStyleSheet(buttonStyle);
 
+    analysisButton_->setCheckable(true);
+    analysisLinesBox_->setRange(1, 8);
+    analysisLinesBox_->setValue(3);
+    analysisLinesBox_->setSuffix(tr(" линий"));
+    analysisList_->setStyleSheet(historyList_->styleSheet());
+    analysisList_->setVisible(false);
+
+    auto *analysisRow = new QHBoxLayout();
+    analysisRow->addWidget(analysisButton_, 1);
+    analysisRow->addWidget(analysisLinesBox_);
+    analysisRow->addWidget(prevButton_);
+    analysisRow->addWidget(nextButton_);
+
+    clockLabel_->setStyleSheet(
+        "QLabel {"
+        "   color: white;"
+        "   font-family: 'Courier New', monospace;"
+        "   font-size: 14pt;"
+        "}"
+        );
+    clockLabel_->setAlignment(Qt::AlignCenter);
+    clockLabel_->setVisible(timeControl.baseMs > 0);
+
+    sideLayout->addWidget(clockLabel_);
     sideLayout->addWidget(historyList_);
+    sideLayout->addLayout(analysisRow);
+    sideLayout->addWidget(analysisList_);
     sideLayout->addWidget(resignButton_);
     sideLayout->addWidget(returnToMenuButton_);
 
@@ -75,11 +112,18 @@ MenuWindow::MenuWindow(bool vsEngine, int engineElo, bool engineIsWhite, QWidget
     connect(resignButton_, &QPushButton::clicked, this, &MenuWindow::onResign);
     connect(returnToMenuButton_, &QPushButton::clicked, this, &MenuWindow::onReturnToMenu);
     connect(board_, &ChessBoardWidget::moveMade, this, &MenuWindow::onMoveMade);
+    connect(board_, &ChessBoardWidget::clockChanged, this, &MenuWindow::onClockChanged);
+    connect(analysisButton_, &QPushButton::toggled, this, &MenuWindow::onAnalysisToggled);
+    connect(analysisLinesBox_, &QSpinBox::valueChanged, this, &MenuWindow::restartAnalysis);
+    connect(prevButton_, &QPushButton::clicked, this, [this] { board_->stepView(-1); });
+    connect(nextButton_, &QPushButton::clicked, this, [this] { board_->stepView(1); });
+    connect(board_, &ChessBoardWidget::shownPositionChanged, this, &MenuWindow::restartAnalysis);
     connect(board_, &ChessBoardWidget::gameReset, this, [this]() {
         historyList_->clear();
         halfmoveCount_ = 0;
     });
 
+    board_->setTimeControl(timeControl);
     if (vsEngine_) {
         board_->setPlayVsEngine(true, engineIsWhite_, engineElo_);
     } else {
@@ -87,6 +131,10 @@ MenuWindow::MenuWindow(bool vsEngine, int engineElo, bool engineIsWhite, QWidget
     }
 }
 
+MenuWindow::~MenuWindow() {
+    EnginePool::instance().release(analysisEngine_);
+}
+
 void MenuWindow::onResign() {
     Color loser = board_->sideToMove();
     QString winner = (loser == Color::White) ? tr("Чёрные") : tr("Белые");
@@ -114,3 +162,77 @@ void MenuWindow::onReturnToMenu() {
     mainMenu->show();
     close();
 }
+
+static QString formatClock(qint64 ms) {
+    const qint64 seconds = qMax<qint64>(0, ms) / 1000;
+    return QString("%1:%2").arg(seconds / 60, 2, 10, QChar('0')).arg(seconds % 60, 2, 10, QChar('0'));
+}
+
+void MenuWindow::onClockChanged(qint64 whiteMs, qint64 blackMs) {
+    clockLabel_->setText(tr("Белые %1   Чёрные %2").arg(formatClock(whiteMs), formatClock(blackMs)));
+}
+
+void MenuWindow::onAnalysisToggled(bool enabled) {
+    analysisList_->setVisible(enabled);
+    analysisList_->clear();
+    analysisSearching_ = false;
+    analysisStopsPending_ = 0;
+    if (!enabled) {
+        EnginePool::instance().release(analysisEngine_);
+        analysisEngine_ = nullptr;
+        return;
+    }
+    analysisEngine_ = EnginePool::instance().acquire();
+    analysisEngine_->setDifficultyElo(3000, false);
+    connect(analysisEngine_, &ChessEngine::searchInfo, this, &MenuWindow::onAnalysisInfo);
+    connect(analysisEngine_, &ChessEngine::bestMove, this, &MenuWindow::onAnalysisBestMove);
+    restartAnalysis();
+}
+
+// The same engine process follows every position change: stop, new position, search again.
+void MenuWindow::restartAnalysis() {
+    if (!analysisEngine_) return;
+    const int lines = analysisLinesBox_->value();
+    if (analysisSearching_) ++analysisStopsPending_;
+    analysisEngine_->stop();
+    analysisEngine_->setOption("MultiPV", QString::number(lines));
+    analysisPosition_ = board_->shownPosition();
+    analysisList_->clear();
+    for (int i = 0; i < lines; ++i) analysisList_->addItem(QString());
+    analysisEngine_->setPositionFromStartpos(board_->shownMovesAsUci());
+    analysisEngine_->goInfinite();
+    analysisSearching_ = true;
+}
+
+// Every search ends with a bestmove: either one restartAnalysis() stopped, or the current one
+// finishing by itself (a forced mate within reach).
+void MenuWindow::onAnalysisBestMove() {
+    if (analysisStopsPending_ > 0) --analysisStopsPending_;
+    else analysisSearching_ = false;
+}
+
+void MenuWindow::onAnalysisInfo(const UciInfo &info) {
+    if (analysisStopsPending_ > 0) return;
+    if (info.multiPv > analysisList_->count() || info.pv.empty()) return;
+
+    GameState state = analysisPosition_;
+    QStringList san;
+    for (PackedMove packed: info.pv) {
+        if (san.size() == 10) break;
+        const auto move = Move::fromUCIInPosition(packed.toUCI(), state);
+        if (!move || !state.board().pieceAt(move->fromRow, move->fromCol)) {
+            if (san.isEmpty()) return;
+            break;
+        }
+        san << ChessBoardWidget::moveToSan(state, *move);
+        state.applyMove(*move);
+    }
+
+    // Engines score for the side to move; the panel always shows White's view.
+    const int sign = analysisPosition_.sideToMove() == Color::White ? 1 : -1;
+    const QString score = info.isMate
+                              ? QString("#%1").arg(sign * info.score)
+                              : QString::asprintf("%+.2f", sign * info.score / 100.0);
+    analysisList_->item(info.multiPv - 1)->setText(
+        QString("%1  d%2  %3").arg(score).arg(info.depth).arg(san.join(' ')));
+}
@@ -4,26 +4,47 @@
 #include <QWidget>
 #include <QListWidget>
 #include <QPushButton>
+#include <QLabel>
+#include <QSpinBox>
 #include "ChessBoardWidget.h"
+#include "engine/ChessEngine.h"
 
 class MenuWindow : public QWidget {
     Q_OBJECT
 public:
     explicit MenuWindow(QWidget* parent = nullptr);
     MenuWindow(bool vsEngine, int engineElo, bool engineIsWhite,
+               const ChessBoardWidget::TimeControl& timeControl = {},
                QWidget* parent = nullptr);
-    ~MenuWindow() override = default;
+    ~MenuWindow() override;
 
 private slots:
     void onResign();
     void onMoveMade(const QString& san);
     void onReturnToMenu();
+    void onClockChanged(qint64 whiteMs, qint64 blackMs);
+    void onAnalysisToggled(bool enabled);
+    void onAnalysisInfo(const UciInfo& info);
+    void onAnalysisBestMove();
+    void restartAnalysis();
 
 private:
     ChessBoardWidget* board_;
     QListWidget* historyList_;
+    QLabel* clockLabel_;
     QPushButton* resignButton_;
     QPushButton* returnToMenuButton_;
+    QPushButton* analysisButton_;
+    QSpinBox* analysisLinesBox_;
+    QPushButton* prevButton_;
+    QPushButton* nextButton_;
+    QListWidget* analysisList_;
+    // Leased from the engine pool while analysis is on; separate from the opponent engine.
+    ChessEngine* analysisEngine_ = nullptr;
+    GameState analysisPosition_;
+    bool analysisSearching_ = false;
+    // Stopped searches whose bestmove has not arrived yet; their info lines are for an older position.
+    int analysisStopsPending_ = 0;
     bool vsEngine_;
     int engineElo_;
     bool engineIsWhite_;
@@ -1,215 +1,257 @@
 #include "MoveGen.h"
+#include "Attacks.h"
 #include <algorithm>
 
-static const int ROOK_DIRS[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
-static const int BISHOP_DIRS[4][2] = {{1, 1}, {1, -1}, {-1, 1}, {-1, -1}};
-static const int KNIGHT_OFFSETS[8][2] = {{2, 1}, {2, -1}, {-2, 1}, {-2, -1}, {1, 2}, {1, -2}, {-1, 2}, {-1, -2}};
-
 inline Color opposite(Color c) {
     return c == Color::White ? Color::Black : Color::White;
 }
 
-std::vector<Move> MoveGenerator::generateLegal(const GameState &state) {
-    auto pseudo = generatePseudoLegal(state);
-    std::vector<Move> legal;
-    for (auto &m: pseudo) {
-        GameState copy = state;
-        copy.applyMove(m);
-        if (!isInCheck(copy.board(), state.sideToMove())) {
-            legal.push_back(m);
+namespace {
+    void addPromotions(MoveList &moves, int from, int to) {
+        moves.emplace_back(from, to, PackedMove::Promotion, PieceType::Queen);
+        moves.emplace_back(from, to, PackedMove::Promotion, PieceType::Rook);
+        moves.emplace_back(from, to, PackedMove::Promotion, PieceType::Bishop);
+        moves.emplace_back(from, to, PackedMove::Promotion, PieceType::Knight);
+    }
+
+    void addMoves(MoveList &moves, int from, Bitboard targets) {
+        while (targets) {
+            moves.emplace_back(from, bb::popLsb(targets));
         }
     }
-    return legal;
 }
 
-std::vector<Move> MoveGenerator::generatePseudoLegal(const GameState &state) {
-    const Board &board = state.board();
-    Color side = state.sideToMove();
+std::vector<Move> MoveGenerator::generateLegal(const GameState &state) {
+    MoveList packed;
+    generateLegal(state, packed);
     std::vector<Move> moves;
-
-    for (int r = 0; r < Board::SIZE; ++r) {
-        for (int c = 0; c < Board::SIZE; ++c) {
-            auto opt = board.pieceAt(r, c);
-            if (!opt || opt->color() != side) continue;
-            PieceType pt = opt->type();
-            switch (pt) {
-                case PieceType::Pawn: {
-                    int dir = (side == Color::White ? 1 : -1);
-                    int startRow = (side == Color::White ? 1 : 6);
-                    int nr = r + dir;
-                    if (board.isInside(nr, c) && !board.pieceAt(nr, c)) {
-                        if (nr == 0 || nr == 7) {
-                            moves.emplace_back(r, c, nr, c, PieceType::Queen);
-                            moves.emplace_back(r, c, nr, c, PieceType::Rook);
-                            moves.emplace_back(r, c, nr, c, PieceType::Bishop);
-                            moves.emplace_back(r, c, nr, c, PieceType::Knight);
-                        } else {
-                            moves.emplace_back(r, c, nr, c);
-                            if (r == startRow) {
-                                int nr2 = r + 2 * dir;
-                                if (board.isInside(nr2, c) && !board.pieceAt(nr2, c)) {
-                                    moves.emplace_back(r, c, nr2, c);
-                                }
-                            }
-                        }
-                    }
-                    for (int dc: {-1, 1}) {
-                        int cc = c + dc;
-                        if (!board.isInside(nr, cc)) continue;
-                        auto target = board.pieceAt(nr, cc);
-                        if (target && target->color() != side) {
-                            if (nr == 0 || nr == 7) {
-                                moves.emplace_back(r, c, nr, cc, PieceType::Queen);
-                                moves.emplace_back(r, c, nr, cc, PieceType::Rook);
-                                moves.emplace_back(r, c, nr, cc, PieceType::Bishop);
-                                moves.emplace_back(r, c, nr, cc, PieceType::Knight);
-                            } else {
-                                moves.emplace_back(r, c, nr, cc);
-                            }
-                        }
-                        auto ep = state.enPassantTarget();
-                        if (!target && ep && ep->first == nr && ep->second == cc) {
-                            Move m(r, c, nr, cc);
-                            m.isEnPassant = true;
-                            moves.push_back(m);
-                        }
-                    }
-                    break;
-                }
-                case PieceType::Knight: {
-                    for (auto &off: KNIGHT_OFFSETS) {
-                        int nr = r + off[0], nc = c + off[1];
-                        if (!board.isInside(nr, nc)) continue;
-                        auto t = board.pieceAt(nr, nc);
-                        if (!t || t->color() != side) moves.emplace_back(r, c, nr, nc);
-                    }
-                    break;
-                }
-                case PieceType::Bishop:
-                case PieceType::Rook:
-                case PieceType::Queen: {
-                    auto processDir = [&](int dr, int dc) {
-                        for (int step = 1; step < Board::SIZE; ++step) {
-                            int nr = r + dr * step, nc = c + dc * step;
-                            if (!board.isInside(nr, nc)) break;
-                            auto t = board.pieceAt(nr, nc);
-                            if (!t) moves.emplace_back(r, c, nr, nc);
-                            else {
-                                if (t->color() != side) moves.emplace_back(r, c, nr, nc);
-                                break;
-                            }
-                        }
-                    };
-                    if (pt == PieceType::Bishop || pt == PieceType::Queen)
-                        for (auto &d: BISHOP_DIRS) processDir(d[0], d[1]);
-                    if (pt == PieceType::Rook || pt == PieceType::Queen)
-                        for (auto &d: ROOK_DIRS) processDir(d[0], d[1]);
-                    break;
-                }
-                case PieceType::King: {
-                    for (int dr = -1; dr <= 1; ++dr)
-                        for (int dc = -1; dc <= 1; ++dc) {
-                            if (dr == 0 && dc == 0) continue;
-                            int nr = r + dr, nc = c + dc;
-                            if (!board.isInside(nr, nc)) continue;
-                            auto t = board.pieceAt(nr, nc);
-                            if (!t || t->color() != side) moves.emplace_back(r, c, nr, nc);
-                        }
-                    if (!isInCheck(board, side)) {
-                        int backRank = (side == Color::White ? 0 : 7);
-                        if (state.canCastleKingSide(side)
-                            && !board.pieceAt(backRank, 5)
-                            && !board.pieceAt(backRank, 6)
-                            && !isAttacked(board, backRank, 5, opposite(side))
-                            && !isAttacked(board, backRank, 6, opposite(side))) {
-                            Move m(backRank, 4, backRank, 6);
-                            m.isCastling = true;
-                            moves.push_back(m);
-                        }
-                        if (state.canCastleQueenSide(side)
-                            && !board.pieceAt(backRank, 3)
-                            && !board.pieceAt(backRank, 2)
-                            && !board.pieceAt(backRank, 1)
-                            && !isAttacked(board, backRank, 3, opposite(side))
-                            && !isAttacked(board, backRank, 2, opposite(side))) {
-                            Move m(backRank, 4, backRank, 2);
-                            m.isCastling = true;
-                            moves.push_back(m);
-                        }
-                    }
-                    break;
-                }
-            }
-        }
+    moves.reserve(packed.size());
+    for (PackedMove m: packed) {
+        moves.push_back(m.toMove());
     }
     return moves;
 }
 
-bool MoveGenerator::isInCheck(const Board &board, Color color) {
-    int kr = -1, kc = -1;
-    for (int r = 0; r < Board::SIZE; ++r)
-        for (int c = 0; c < Board::SIZE; ++c) {
-            auto p = board.pieceAt(r, c);
-            if (p && p->type() == PieceType::King && p->color() == color) {
-                kr = r;
-                kc = c;
-            }
-        }
-    if (kr < 0) return false;
-    return isAttacked(board, kr, kc, (color == Color::White ? Color::Black : Color::White));
+void MoveGenerator::generateLegal(const GameState &state, MoveList &moves, GenType type) {
+    generate(state, moves, ~Bitboard{0}, type);
+}
+
+void MoveGenerator::generateLegal(const GameState &state, int row, int col, MoveList &moves) {
+    generate(state, moves, bb::squareBB(bb::square(row, col)), GenType::All);
 }
 
-bool MoveGenerator::isAttacked(const Board &board, int row, int col, Color attacker) {
-    int dir = (attacker == Color::White ? 1 : -1);
-    for (int dc: {-1, 1}) {
-        int rr = row - dir, cc = col + dc;
-        if (board.isInside(rr, cc)) {
-            auto p = board.pieceAt(rr, cc);
-            if (p && p->type() == PieceType::Pawn && p->color() == attacker) return true;
+void MoveGenerator::generate(const GameState &state, MoveList &moves, Bitboard origins, GenType type) {
+    const Board &board = state.board();
+    const Color us = state.sideToMove();
+    const Color them = opposite(us);
+    const Bitboard occupied = board.occupied();
+    const Bitboard own = board.pieces(us);
+    const Bitboard enemy = board.pieces(them);
+    const int king = board.kingSquare(us);
+    const Bitboard targetMask = type == GenType::Captures ? enemy
+                                : type == GenType::Quiets ? ~occupied
+                                : ~Bitboard{0};
+    moves.clear();
+
+    Bitboard checkers = 0, pinned = 0;
+    if (king >= 0) {
+        checkers = attackersTo(board, king, occupied) & enemy;
+        pinned = pinnedPieces(board, us, king);
+
+        Bitboard kingTargets = (origins & bb::squareBB(king)) ? Attacks::king(king) & ~own & targetMask : 0;
+        const Bitboard withoutKing = occupied ^ bb::squareBB(king);
+        while (kingTargets) {
+            const int to = bb::popLsb(kingTargets);
+            if (!isAttacked(board, to, them, withoutKing)) addMoves(moves, king, bb::squareBB(to));
+        }
+        if (bb::popCount(checkers) > 1) return;
+    }
+
+    // Evasions must capture the checker or block the ray; pinned pieces stay on the pin line.
+    Bitboard evasion = ~Bitboard{0};
+    if (checkers) {
+        const int checker = bb::lsb(checkers);
+        evasion = Attacks::between(king, checker) | checkers;
+    }
+    auto pinMask = [&](int from) {
+        return (pinned & bb::squareBB(from)) ? Attacks::line(king, from) : ~Bitboard{0};
+    };
+
+    const Bitboard promoRank = us == Color::White ? bb::RANK_8 : bb::RANK_1;
+    const int push = us == Color::White ? 8 : -8;
+    const int startRow = us == Color::White ? 1 : 6;
+
+    Bitboard pawns = board.pieces(us, PieceType::Pawn) & origins;
+    while (pawns) {
+        const int from = bb::popLsb(pawns);
+        const Bitboard allowed = evasion & pinMask(from);
+        const int to = from + push;
+        Bitboard captures = Attacks::pawn(us, from) & enemy;
+        Bitboard pushes = 0;
+        if (board.isEmpty(to)) {
+            pushes |= bb::squareBB(to);
+            if (bb::rowOf(from) == startRow && board.isEmpty(to + push)) pushes |= bb::squareBB(to + push);
+        }
+        Bitboard targets = captures | pushes;
+        if (type == GenType::Captures) targets = captures | (pushes & promoRank);
+        else if (type == GenType::Quiets) targets = pushes & ~promoRank;
+        targets &= allowed;
+        while (targets) {
+            const int t = bb::popLsb(targets);
+            if (bb::squareBB(t) & promoRank) addPromotions(moves, from, t);
+            else addMoves(moves, from, bb::squareBB(t));
         }
     }
-    for (auto &off: KNIGHT_OFFSETS) {
-        int rr = row + off[0], cc = col + off[1];
-        if (board.isInside(rr, cc)) {
-            auto p = board.pieceAt(rr, cc);
-            if (p && p->type() == PieceType::Knight && p->color() == attacker) return true;
+
+    auto ep = type != GenType::Quiets ? state.enPassantTarget() : std::nullopt;
+    if (ep) {
+        const int to = bb::square(ep->first, ep->second);
+        const int captured = to - push;
+        Bitboard attackers = Attacks::pawn(them, to) & board.pieces(us, PieceType::Pawn) & origins;
+        while (attackers && king >= 0 && (evasion & (bb::squareBB(to) | bb::squareBB(captured)))) {
+            const int from = bb::popLsb(attackers);
+            // Both pawns leave the rank at once, so verify the king with the resulting occupancy.
+            const Bitboard after = (occupied ^ bb::squareBB(from) ^ bb::squareBB(captured)) | bb::squareBB(to);
+            const Bitboard rooks = board.pieces(them, PieceType::Rook) | board.pieces(them, PieceType::Queen);
+            const Bitboard bishops = board.pieces(them, PieceType::Bishop) | board.pieces(them, PieceType::Queen);
+            if ((Attacks::rook(king, after) & rooks) || (Attacks::bishop(king, after) & bishops)) continue;
+            moves.emplace_back(from, to, PackedMove::EnPassant);
         }
     }
-    for (auto &d: ROOK_DIRS) {
-        for (int step = 1; step < Board::SIZE; ++step) {
-            int rr = row + d[0] * step, cc = col + d[1] * step;
-            if (!board.isInside(rr, cc)) break;
-            auto p = board.pieceAt(rr, cc);
-            if (p) {
-                if (p->color() == attacker && (p->type() == PieceType::Rook || p->type() == PieceType::Queen))
-                    return
-                            true;
-                break;
-            }
+
+    Bitboard pieces = own & ~board.pieces(PieceType::Pawn) & ~board.pieces(PieceType::King) & origins;
+    while (pieces) {
+        const int from = bb::popLsb(pieces);
+        const PieceType pt = board.pieceOn(from)->type();
+        addMoves(moves, from, Attacks::attacks(pt, us, from, occupied) & ~own & targetMask & evasion & pinMask(from));
+    }
+
+    if (king >= 0 && !checkers && type != GenType::Captures && (origins & bb::squareBB(king))) {
+        int backRank = (us == Color::White ? 0 : 7);
+        if (state.canCastleKingSide(us)
+            && board.isEmpty(bb::square(backRank, 5))
+            && board.isEmpty(bb::square(backRank, 6))
+            && !isAttacked(board, bb::square(backRank, 5), them, occupied)
+            && !isAttacked(board, bb::square(backRank, 6), them, occupied)) {
+            moves.emplace_back(bb::square(backRank, 4), bb::square(backRank, 6), PackedMove::Castling);
+        }
+        if (state.canCastleQueenSide(us)
+            && board.isEmpty(bb::square(backRank, 3))
+            && board.isEmpty(bb::square(backRank, 2))
+            && board.isEmpty(bb::square(backRank, 1))
+            && !isAttacked(board, bb::square(backRank, 3), them, occupied)
+            && !isAttacked(board, bb::square(backRank, 2), them, occupied)) {
+            moves.emplace_back(bb::square(backRank, 4), bb::square(backRank, 2), PackedMove::Castling);
+        }
+    }
+}
+
+bool MoveGenerator::isInCheck(const Board &board, Color color) {
+    const int king = board.kingSquare(color);
+    if (king < 0) return false;
+    return isAttacked(board, king, opposite(color), board.occupied());
+}
+
+bool MoveGenerator::isAttacked(const Board &board, int sq, Color attacker, Bitboard occupied) {
+    return attackersTo(board, sq, occupied) & board.pieces(attacker);
+}
+
+Bitboard MoveGenerator::attackersTo(const Board &board, int sq, Bitboard occupied) {
+    const Bitboard queens = board.pieces(PieceType::Queen);
+    return (Attacks::pawn(Color::Black, sq) & board.pieces(Color::White, PieceType::Pawn))
+           | (Attacks::pawn(Color::White, sq) & board.pieces(Color::Black, PieceType::Pawn))
+           | (Attacks::knight(sq) & board.pieces(PieceType::Knight))
+           | (Attacks::king(sq) & board.pieces(PieceType::King))
+           | (Attacks::bishop(sq, occupied) & (board.pieces(PieceType::Bishop) | queens))
+           | (Attacks::rook(sq, occupied) & (board.pieces(PieceType::Rook) | queens));
+}
+
+int MoveGenerator::seeValue(PieceType type) noexcept {
+    switch (type) {
+        case PieceType::King: return 0;
+        case PieceType::Queen: return 900;
+        case PieceType::Rook: return 500;
+        case PieceType::Bishop: return 330;
+        case PieceType::Knight: return 320;
+        case PieceType::Pawn: return 100;
+    }
+    return 0;
+}
+
+bool MoveGenerator::see(const Board &board, PackedMove move, int threshold) {
+    // Castling, en passant and promotions don't fit the swap model; treat them as even trades.
+    if (move.flag() != PackedMove::Normal) return threshold <= 0;
+
+    const int from = move.from(), to = move.to();
+    const auto victim = board.pieceOn(to);
+    int swap = (victim ? seeValue(victim->type()) : 0) - threshold;
+    if (swap < 0) return false;
+    const Piece mover = *board.pieceOn(from);
+    swap = seeValue(mover.type()) - swap;
+    if (swap <= 0) return true;
+
+    // Pieces pinned to their king may only join the exchange along the pin line.
+    Bitboard allowed[2] = {~Bitboard{0}, ~Bitboard{0}};
+    for (const Color c: {Color::White, Color::Black}) {
+        const int king = board.kingSquare(c);
+        if (king < 0) continue;
+        Bitboard pinned = pinnedPieces(board, c, king);
+        while (pinned) {
+            const int sq = bb::popLsb(pinned);
+            if (!(Attacks::line(king, sq) & bb::squareBB(to))) allowed[static_cast<int>(c)] ^= bb::squareBB(sq);
         }
     }
-    for (auto &d: BISHOP_DIRS) {
-        for (int step = 1; step < Board::SIZE; ++step) {
-            int rr = row + d[0] * step, cc = col + d[1] * step;
-            if (!board.isInside(rr, cc)) break;
-            auto p = board.pieceAt(rr, cc);
-            if (p) {
-                if (p->color() == attacker && (p->type() == PieceType::Bishop || p->type() == PieceType::Queen))
-                    return
-                            true;
+
+    const Bitboard bishops = board.pieces(PieceType::Bishop) | board.pieces(PieceType::Queen);
+    const Bitboard rooks = board.pieces(PieceType::Rook) | board.pieces(PieceType::Queen);
+    Bitboard occupied = board.occupied() ^ bb::squareBB(from) ^ bb::squareBB(to);
+    Bitboard attackers = attackersTo(board, to, occupied);
+    Color stm = mover.color();
+    bool result = true;
+
+    while (true) {
+        stm = opposite(stm);
+        attackers &= occupied;
+        const Bitboard stmAttackers = attackers & board.pieces(stm) & allowed[static_cast<int>(stm)];
+        if (!stmAttackers) break;
+        result = !result;
+
+        // Recapture with the least valuable piece; removing it may uncover a slider behind it.
+        Bitboard least = 0;
+        PieceType type = PieceType::King;
+        for (const PieceType pt: {PieceType::Pawn, PieceType::Knight, PieceType::Bishop,
+                                  PieceType::Rook, PieceType::Queen}) {
+            if ((least = stmAttackers & board.pieces(pt))) {
+                type = pt;
                 break;
             }
         }
-    }
-    for (int dr = -1; dr <= 1; ++dr)
-        for (int dc = -1; dc <= 1; ++dc) {
-            if (dr == 0 && dc == 0) continue;
-            int rr = row + dr, cc = col + dc;
-            if (!board.isInside(rr, cc)) continue;
-            auto p = board.pieceAt(rr, cc);
-            if (p && p->type() == PieceType::King && p->color() == attacker) return true;
+        if (type == PieceType::King) {
+            // The king may only take last, when the other side has nothing left to recapture.
+            return (attackers & ~board.pieces(stm)) ? !result : result;
         }
-    return false;
-}
 
+        swap = seeValue(type) - swap;
+        if (swap < static_cast<int>(result)) break;
+        occupied ^= bb::squareBB(bb::lsb(least));
+        if (type == PieceType::Pawn || type == PieceType::Bishop || type == PieceType::Queen)
+            attackers |= Attacks::bishop(to, occupied) & bishops;
+        if (type == PieceType::Rook || type == PieceType::Queen)
+            attackers |= Attacks::rook(to, occupied) & rooks;
+    }
+    return result;
+}
 
+Bitboard MoveGenerator::pinnedPieces(const Board &board, Color color, int kingSq) {
+    const Color them = opposite(color);
+    const Bitboard queens = board.pieces(them, PieceType::Queen);
+    Bitboard snipers = (Attacks::rook(kingSq, 0) & (board.pieces(them, PieceType::Rook) | queens))
+                       | (Attacks::bishop(kingSq, 0) & (board.pieces(them, PieceType::Bishop) | queens));
+    Bitboard pinned = 0;
+    while (snipers) {
+        const int sniper = bb::popLsb(snipers);
+        const Bitboard blockers = Attacks::between(kingSq, sniper) & board.occupied();
+        if (bb::popCount(blockers) == 1) pinned |= blockers & board.pieces(color);
+    }
+    return pinned;
+}
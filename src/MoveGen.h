@@ -2,18 +2,40 @@
 #define MOVEGEN_H
 
 #include <vector>
+#include "Bitboard.h"
 #include "GameState.h"
 #include "Move.h"
+#include "MoveList.h"
+#include "PackedMove.h"
 #include "Piece.h"
 
 class MoveGenerator {
 public:
+    // Captures include en passant and every promotion; quiets are everything else, castling included.
+    enum class GenType {
+        All,
+        Captures,
+        Quiets
+    };
+
     static std::vector<Move> generateLegal(const GameState& state);
+    static void generateLegal(const GameState& state, MoveList& moves, GenType type = GenType::All);
+    static void generateLegal(const GameState& state, int row, int col, MoveList& moves);
     static bool isInCheck(const Board& board, Color color);
 
+    // All pieces of either color attacking sq, with sliders seen through the given occupancy.
+    static Bitboard attackersTo(const Board& board, int sq, Bitboard occupied);
+
+    // Static exchange evaluation: true if the capture sequence started by move on its target
+    // square nets at least threshold centipawns for the mover. Includes x-ray attackers.
+    static bool see(const Board& board, PackedMove move, int threshold = 0);
+
+    static int seeValue(PieceType type) noexcept;
+
 private:
-    static std::vector<Move> generatePseudoLegal(const GameState& state);
-    static bool isAttacked(const Board& board, int row, int col, Color attacker);
+    static void generate(const GameState& state, MoveList& moves, Bitboard origins, GenType type);
+    static bool isAttacked(const Board& board, int sq, Color attacker, Bitboard occupied);
+    static Bitboard pinnedPieces(const Board& board, Color color, int kingSq);
 };
 
 #endif //MOVEGEN_H
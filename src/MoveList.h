@@ -0,0 +1,42 @@
+#ifndef MOVELIST_H
+#define MOVELIST_H
+
+#include <algorithm>
+#include <cstddef>
+#include "PackedMove.h"
+
+// Fixed-capacity, stack-allocated move list; 256 exceeds the legal move count of any position.
+class MoveList {
+public:
+    static constexpr std::size_t CAPACITY = 256;
+
+    MoveList() noexcept : size_(0) {}
+
+    void push_back(PackedMove move) noexcept { moves_[size_++] = move; }
+
+    template<typename... Args>
+    void emplace_back(Args &&... args) noexcept { moves_[size_++] = PackedMove(args...); }
+
+    void clear() noexcept { size_ = 0; }
+
+    [[nodiscard]] std::size_t size() const noexcept { return size_; }
+    [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+
+    PackedMove &operator[](std::size_t i) noexcept { return moves_[i]; }
+    const PackedMove &operator[](std::size_t i) const noexcept { return moves_[i]; }
+
+    PackedMove *begin() noexcept { return moves_; }
+    PackedMove *end() noexcept { return moves_ + size_; }
+    [[nodiscard]] const PackedMove *begin() const noexcept { return moves_; }
+    [[nodiscard]] const PackedMove *end() const noexcept { return moves_ + size_; }
+
+    [[nodiscard]] bool contains(PackedMove move) const noexcept {
+        return std::find(begin(), end(), move) != end();
+    }
+
+private:
+    PackedMove moves_[CAPACITY];
+    std::size_t size_;
+};
+
+#endif //MOVELIST_H
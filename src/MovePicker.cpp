@@ -0,0 +1,206 @@
+#include "MovePicker.h"
+#include <algorithm>
+#include <cstdlib>
+
+void MoveHeuristics::clear() noexcept {
+    killers = {};
+    history = {};
+    counterMoves = {};
+}
+
+void MoveHeuristics::onQuietCutoff(Color side, int ply, PackedMove move, PackedMove previous, int depth,
+                                   const PackedMove *failed, std::size_t failedCount) noexcept {
+    if (ply < MAX_PLY && killers[ply][0] != move) {
+        killers[ply][1] = killers[ply][0];
+        killers[ply][0] = move;
+    }
+    if (previous) counterMoves[previous.from()][previous.to()] = move;
+
+    // Gravity keeps scores within +-MAX_HISTORY and lets stale entries decay.
+    const int bonus = std::min(depth * depth, 1200);
+    auto update = [&](PackedMove m, int delta) {
+        int &entry = history[static_cast<int>(side)][m.from()][m.to()];
+        entry += delta - entry * std::abs(delta) / MAX_HISTORY;
+    };
+    update(move, bonus);
+    for (std::size_t i = 0; i < failedCount; ++i) {
+        if (failed[i] != move) update(failed[i], -bonus);
+    }
+}
+
+int MoveHeuristics::historyScore(Color side, PackedMove move) const noexcept {
+    return history[static_cast<int>(side)][move.from()][move.to()];
+}
+
+MovePicker::MovePicker(const GameState &state, PackedMove ttMove, const MoveHeuristics *heuristics,
+                       int ply, PackedMove previous)
+    : state_(state)
+      , heuristics_(heuristics)
+      , stage_(Stage::TtMove)
+      , capturesOnly_(false)
+      , ply_(ply)
+      , ttMove_(ttMove)
+      , killers_{}
+      , counterMove_{} {
+    if (heuristics_ && ply_ < MoveHeuristics::MAX_PLY) {
+        killers_[0] = heuristics_->killers[ply_][0];
+        killers_[1] = heuristics_->killers[ply_][1];
+    }
+    if (heuristics_ && previous) counterMove_ = heuristics_->counterMoves[previous.from()][previous.to()];
+    if (!ttMove_ || !isLegal(ttMove_)) {
+        ttMove_ = PackedMove{};
+        stage_ = Stage::GenerateCaptures;
+    }
+}
+
+MovePicker::MovePicker(const GameState &state, PackedMove ttMove)
+    : state_(state)
+      , heuristics_(nullptr)
+      , stage_(Stage::TtMove)
+      , capturesOnly_(true)
+      , ply_(0)
+      , ttMove_(ttMove)
+      , killers_{}
+      , counterMove_{} {
+    const bool tactical = ttMove_ && (isCapture(ttMove_)
+                                      || (ttMove_.isPromotion() && ttMove_.promotionType() == PieceType::Queen));
+    if (!tactical || !isLegal(ttMove_)) {
+        ttMove_ = PackedMove{};
+        stage_ = Stage::GenerateCaptures;
+    }
+}
+
+PackedMove MovePicker::next() {
+    while (true) {
+        switch (stage_) {
+            case Stage::TtMove:
+                stage_ = Stage::GenerateCaptures;
+                return ttMove_;
+
+            case Stage::GenerateCaptures: {
+                MoveList generated;
+                MoveGenerator::generateLegal(state_, generated, MoveGenerator::GenType::Captures);
+                captures_.clear();
+                badCaptures_.clear();
+                for (const PackedMove move: generated) {
+                    if (move == ttMove_) continue;
+                    if (capturesOnly_ && move.isPromotion() && move.promotionType() != PieceType::Queen
+                        && !isCapture(move))
+                        continue;
+                    // The quiescence search tries every capture, so there is nothing to hold back.
+                    if (!capturesOnly_ && isLosingCapture(move)) {
+                        badCaptures_.push_back(move);
+                        continue;
+                    }
+                    captureScores_[captures_.size()] = mvvLva(state_.board(), move);
+                    captures_.push_back(move);
+                }
+                captureIndex_ = 0;
+                badIndex_ = 0;
+                stage_ = Stage::GoodCaptures;
+                break;
+            }
+
+            case Stage::GoodCaptures:
+                if (captureIndex_ < captures_.size()) return pickBest(captures_, captureScores_, captureIndex_);
+                stage_ = capturesOnly_ ? Stage::Done : Stage::FirstKiller;
+                break;
+
+            case Stage::FirstKiller:
+                stage_ = Stage::SecondKiller;
+                if (killers_[0] && killers_[0] != ttMove_ && isLegalQuiet(killers_[0])) return killers_[0];
+                killers_[0] = PackedMove{};
+                break;
+
+            case Stage::SecondKiller:
+                stage_ = Stage::CounterMove;
+                if (killers_[1] && killers_[1] != ttMove_ && killers_[1] != killers_[0]
+                    && isLegalQuiet(killers_[1]))
+                    return killers_[1];
+                killers_[1] = PackedMove{};
+                break;
+
+            case Stage::CounterMove:
+                stage_ = Stage::GenerateQuiets;
+                if (counterMove_ && counterMove_ != ttMove_ && counterMove_ != killers_[0]
+                    && counterMove_ != killers_[1] && isLegalQuiet(counterMove_))
+                    return counterMove_;
+                counterMove_ = PackedMove{};
+                break;
+
+            case Stage::GenerateQuiets: {
+                MoveList generated;
+                MoveGenerator::generateLegal(state_, generated, MoveGenerator::GenType::Quiets);
+                quiets_.clear();
+                const Color side = state_.sideToMove();
+                for (const PackedMove move: generated) {
+                    if (alreadyTried(move)) continue;
+                    quietScores_[quiets_.size()] = heuristics_ ? heuristics_->historyScore(side, move) : 0;
+                    quiets_.push_back(move);
+                }
+                quietIndex_ = 0;
+                stage_ = Stage::Quiets;
+                break;
+            }
+
+            case Stage::Quiets:
+                if (quietIndex_ < quiets_.size()) return pickBest(quiets_, quietScores_, quietIndex_);
+                stage_ = Stage::BadCaptures;
+                break;
+
+            case Stage::BadCaptures:
+                if (badIndex_ < badCaptures_.size()) return badCaptures_[badIndex_++];
+                stage_ = Stage::Done;
+                break;
+
+            case Stage::Done:
+                return PackedMove{};
+        }
+    }
+}
+
+int MovePicker::mvvLva(const Board &board, PackedMove move) noexcept {
+    const auto victim = move.isEnPassant() ? std::optional<Piece>(Piece(PieceType::Pawn, Color::White))
+                                           : board.pieceOn(move.to());
+    const int victimValue = victim ? MoveGenerator::seeValue(victim->type()) : 0;
+    const int promotion = move.isPromotion() ? MoveGenerator::seeValue(move.promotionType()) : 0;
+    const int attacker = MoveGenerator::seeValue(board.pieceOn(move.from())->type());
+    return (victimValue + promotion) * 16 - attacker / 100;
+}
+
+bool MovePicker::isCapture(PackedMove move) const noexcept {
+    return move.isEnPassant() || !state_.board().isEmpty(move.to());
+}
+
+bool MovePicker::isLegalQuiet(PackedMove move) const {
+    return !isCapture(move) && !move.isPromotion() && isLegal(move);
+}
+
+bool MovePicker::isLegal(PackedMove move) const {
+    // Hash, killer and counter moves come from other positions; check them against the real list.
+    const int from = move.from();
+    const auto piece = state_.board().pieceOn(from);
+    if (!piece || piece->color() != state_.sideToMove()) return false;
+    MoveList moves;
+    MoveGenerator::generateLegal(state_, bb::rowOf(from), bb::colOf(from), moves);
+    return moves.contains(move);
+}
+
+bool MovePicker::alreadyTried(PackedMove move) const noexcept {
+    return move == ttMove_ || move == killers_[0] || move == killers_[1] || move == counterMove_;
+}
+
+bool MovePicker::isLosingCapture(PackedMove move) const {
+    return !MoveGenerator::see(state_.board(), move, 0);
+}
+
+PackedMove MovePicker::pickBest(MoveList &moves, std::array<int, MoveList::CAPACITY> &scores, std::size_t &index) {
+    // Selection sort one step at a time: after a cutoff the rest is never sorted.
+    std::size_t best = index;
+    for (std::size_t i = index + 1; i < moves.size(); ++i) {
+        if (scores[i] > scores[best]) best = i;
+    }
+    std::swap(moves[index], moves[best]);
+    std::swap(scores[index], scores[best]);
+    return moves[index++];
+}
@@ -0,0 +1,86 @@
+#ifndef MOVEPICKER_H
+#define MOVEPICKER_H
+
+#include <array>
+#include <cstdint>
+#include "GameState.h"
+#include "MoveGen.h"
+#include "MoveList.h"
+#include "PackedMove.h"
+
+// Quiet-move ordering state learnt during a search; one instance per search thread.
+struct MoveHeuristics {
+    static constexpr int MAX_PLY = 64;
+    static constexpr int MAX_HISTORY = 16384;
+
+    std::array<std::array<PackedMove, 2>, MAX_PLY> killers{};
+    std::array<std::array<std::array<int, 64>, 64>, 2> history{};
+    std::array<std::array<PackedMove, 64>, 64> counterMoves{};
+
+    void clear() noexcept;
+
+    // Rewards a quiet move that caused a beta cutoff and penalises the quiets tried before it.
+    void onQuietCutoff(Color side, int ply, PackedMove move, PackedMove previous, int depth,
+                       const PackedMove* failed, std::size_t failedCount) noexcept;
+
+    [[nodiscard]] int historyScore(Color side, PackedMove move) const noexcept;
+};
+
+// Hands out legal moves one at a time in stages, generating each stage only when it is reached,
+// so a cutoff on the hash move or a capture never pays for quiet move generation.
+class MovePicker {
+public:
+    // Main search: hash move, winning captures, killers, countermove, quiets by history, losing captures.
+    MovePicker(const GameState& state, PackedMove ttMove, const MoveHeuristics* heuristics,
+               int ply, PackedMove previous);
+
+    // Quiescence: hash move if tactical, then captures and queen promotions only.
+    MovePicker(const GameState& state, PackedMove ttMove);
+
+    // Returns a null move when exhausted.
+    PackedMove next();
+
+    // Capture ordering key, also usable outside the picker.
+    [[nodiscard]] static int mvvLva(const Board& board, PackedMove move) noexcept;
+
+private:
+    enum class Stage : std::uint8_t {
+        TtMove,
+        GenerateCaptures,
+        GoodCaptures,
+        FirstKiller,
+        SecondKiller,
+        CounterMove,
+        GenerateQuiets,
+        Quiets,
+        BadCaptures,
+        Done
+    };
+
+    [[nodiscard]] bool isCapture(PackedMove move) const noexcept;
+    [[nodiscard]] bool isLegalQuiet(PackedMove move) const;
+    [[nodiscard]] bool isLegal(PackedMove move) const;
+    [[nodiscard]] bool alreadyTried(PackedMove move) const noexcept;
+    [[nodiscard]] bool isLosingCapture(PackedMove move) const;
+    PackedMove pickBest(MoveList& moves, std::array<int, MoveList::CAPACITY>& scores, std::size_t& index);
+
+    const GameState& state_;
+    const MoveHeuristics* heuristics_;
+    Stage stage_;
+    bool capturesOnly_;
+    int ply_;
+    PackedMove ttMove_;
+    PackedMove killers_[2];
+    PackedMove counterMove_;
+
+    MoveList captures_;
+    std::array<int, MoveList::CAPACITY> captureScores_;
+    std::size_t captureIndex_ = 0;
+    MoveList badCaptures_;
+    std::size_t badIndex_ = 0;
+    MoveList quiets_;
+    std::array<int, MoveList::CAPACITY> quietScores_;
+    std::size_t quietIndex_ = 0;
+};
+
+#endif //MOVEPICKER_H
@@ -0,0 +1,21 @@
+#include "PackedMove.h"
+
+PackedMove::PackedMove(const Move &move) noexcept
+    : PackedMove(bb::square(move.fromRow, move.fromCol), bb::square(move.toRow, move.toCol),
+                 move.promotion ? Promotion : move.isEnPassant ? EnPassant : move.isCastling ? Castling : Normal,
+                 move.promotion.value_or(PieceType::Knight)) {
+}
+
+Move PackedMove::toMove() const noexcept {
+    return Move(fromRow(), fromCol(), toRow(), toCol(), promotion(), isCastling(), isEnPassant());
+}
+
+std::string PackedMove::toUCI() const {
+    return toMove().toUCI();
+}
+
+std::optional<PackedMove> PackedMove::fromUCI(const std::string &uci) {
+    auto move = Move::fromUCI(uci);
+    if (!move) return std::nullopt;
+    return PackedMove(*move);
+}
@@ -0,0 +1,76 @@
+#ifndef PACKEDMOVE_H
+#define PACKEDMOVE_H
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include "Bitboard.h"
+#include "Move.h"
+#include "Piece.h"
+
+// 16-bit move: bits 0-5 from, 6-11 to, 12-13 promotion piece (N, B, R, Q), 14-15 flag.
+class PackedMove {
+public:
+    enum Flag : std::uint16_t {
+        Normal = 0,
+        Promotion = 1 << 14,
+        EnPassant = 2 << 14,
+        Castling = 3 << 14
+    };
+
+    // Trivial so that MoveList storage is not zero-filled; PackedMove{} is the null move.
+    PackedMove() noexcept = default;
+
+    constexpr PackedMove(int from, int to, Flag flag = Normal, PieceType promo = PieceType::Knight) noexcept
+        : data_(static_cast<std::uint16_t>(from | (to << 6) | flag
+                                           | (flag == Promotion ? (4 - static_cast<int>(promo)) << 12 : 0))) {
+    }
+
+    explicit PackedMove(const Move& move) noexcept;
+
+    static constexpr PackedMove fromRaw(std::uint16_t raw) noexcept {
+        PackedMove m{};
+        m.data_ = raw;
+        return m;
+    }
+
+    [[nodiscard]] constexpr std::uint16_t raw() const noexcept { return data_; }
+    [[nodiscard]] constexpr int from() const noexcept { return data_ & 0x3F; }
+    [[nodiscard]] constexpr int to() const noexcept { return (data_ >> 6) & 0x3F; }
+    [[nodiscard]] constexpr Flag flag() const noexcept { return static_cast<Flag>(data_ & (3 << 14)); }
+
+    [[nodiscard]] constexpr int fromRow() const noexcept { return bb::rowOf(from()); }
+    [[nodiscard]] constexpr int fromCol() const noexcept { return bb::colOf(from()); }
+    [[nodiscard]] constexpr int toRow() const noexcept { return bb::rowOf(to()); }
+    [[nodiscard]] constexpr int toCol() const noexcept { return bb::colOf(to()); }
+
+    [[nodiscard]] constexpr bool isPromotion() const noexcept { return flag() == Promotion; }
+    [[nodiscard]] constexpr bool isEnPassant() const noexcept { return flag() == EnPassant; }
+    [[nodiscard]] constexpr bool isCastling() const noexcept { return flag() == Castling; }
+
+    [[nodiscard]] constexpr PieceType promotionType() const noexcept {
+        return static_cast<PieceType>(4 - ((data_ >> 12) & 3));
+    }
+
+    [[nodiscard]] std::optional<PieceType> promotion() const noexcept {
+        if (!isPromotion()) return std::nullopt;
+        return promotionType();
+    }
+
+    [[nodiscard]] Move toMove() const noexcept;
+
+    [[nodiscard]] std::string toUCI() const;
+
+    static std::optional<PackedMove> fromUCI(const std::string& uci);
+
+    constexpr explicit operator bool() const noexcept { return data_ != 0; }
+
+    constexpr bool operator==(const PackedMove& o) const noexcept = default;
+
+private:
+    std::uint16_t data_;
+};
+
+static_assert(sizeof(PackedMove) == 2);
+
+#endif //PACKEDMOVE_H
@@ -0,0 +1,119 @@
+#include "Perft.h"
+#include "MoveGen.h"
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <thread>
+
+std::uint64_t Perft::run(GameState &state, int depth, TranspositionTable *tt) {
+    if (depth <= 0) return 1;
+    const bool cached = tt && depth >= 2;
+    TranspositionTable::Entry entry;
+    if (cached && tt->probe(state.key(), entry) && entry.depth() == depth) return entry.count();
+
+    MoveList moves;
+    MoveGenerator::generateLegal(state, moves);
+    if (depth == 1) return moves.size();
+
+    std::uint64_t nodes = 0;
+    GameState::UndoInfo undo;
+    for (PackedMove m: moves) {
+        state.makeMove(m, undo);
+        nodes += run(state, depth - 1, tt);
+        state.unmakeMove(m, undo);
+    }
+    if (cached) tt->storeCount(state.key(), depth, nodes);
+    return nodes;
+}
+
+std::uint64_t Perft::runParallel(const GameState &state, int depth, int threads, TranspositionTable *tt) {
+    if (threads <= 1 || depth < 3) {
+        GameState copy = state;
+        return run(copy, depth, tt);
+    }
+
+    // Split at the second ply as well when the root alone would leave workers idle.
+    const bool splitTwoPlies = depth >= 4;
+    std::vector<std::vector<PackedMove>> paths;
+    GameState root = state;
+    GameState::UndoInfo undo;
+    MoveList rootMoves, replies;
+    MoveGenerator::generateLegal(root, rootMoves);
+    for (PackedMove m: rootMoves) {
+        if (!splitTwoPlies) {
+            paths.push_back({m});
+            continue;
+        }
+        root.makeMove(m, undo);
+        MoveGenerator::generateLegal(root, replies);
+        for (PackedMove reply: replies) {
+            paths.push_back({m, reply});
+        }
+        root.unmakeMove(m, undo);
+    }
+    const auto counts = countPaths(state, paths, depth, threads, tt);
+    return std::accumulate(counts.begin(), counts.end(), std::uint64_t{0});
+}
+
+std::vector<Perft::DivideEntry> Perft::divide(GameState &state, int depth, int threads, TranspositionTable *tt) {
+    std::vector<DivideEntry> result;
+    if (depth <= 0) return result;
+    std::vector<std::vector<PackedMove>> paths;
+    MoveList rootMoves;
+    MoveGenerator::generateLegal(state, rootMoves);
+    for (PackedMove m: rootMoves) {
+        result.push_back({m, 0});
+        paths.push_back({m});
+    }
+    const auto counts = countPaths(state, paths, depth, threads, tt);
+    for (std::size_t i = 0; i < result.size(); ++i) {
+        result[i].nodes = counts[i];
+    }
+    return result;
+}
+
+std::vector<std::uint64_t> Perft::countPaths(const GameState &state,
+                                             const std::vector<std::vector<PackedMove>> &paths,
+                                             int depth, int threads, TranspositionTable *tt) {
+    std::vector<std::uint64_t> counts(paths.size(), 0);
+    std::atomic<std::size_t> next{0};
+
+    auto worker = [&] {
+        GameState local = state;
+        std::vector<GameState::UndoInfo> undo;
+        for (std::size_t i = next++; i < paths.size(); i = next++) {
+            const auto &path = paths[i];
+            undo.resize(path.size());
+            for (std::size_t ply = 0; ply < path.size(); ++ply) {
+                local.makeMove(path[ply], undo[ply]);
+            }
+            counts[i] = run(local, depth - static_cast<int>(path.size()), tt);
+            for (std::size_t ply = path.size(); ply-- > 0;) {
+                local.unmakeMove(path[ply], undo[ply]);
+            }
+        }
+    };
+
+    const int workers = std::max(1, std::min<int>(threads, static_cast<int>(paths.size())));
+    std::vector<std::jthread> pool;
+    pool.reserve(workers - 1);
+    for (int t = 1; t < workers; ++t) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    // Helpers may still be writing their last count; join them before counts is returned.
+    pool.clear();
+    return counts;
+}
+
+const std::vector<Perft::ReferencePosition> &Perft::referencePositions() {
+    static const std::vector<ReferencePosition> positions = {
+        {"startpos", "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 5, 4865609},
+        {"kiwipete", "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 4, 4085603},
+        {"position3", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 5, 674624},
+        {"position4", "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 4, 422333},
+        {"position5", "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 4, 2103487},
+        {"position6", "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10", 4, 3894594},
+    };
+    return positions;
+}
@@ -0,0 +1,41 @@
+#ifndef PERFT_H
+#define PERFT_H
+
+#include <cstdint>
+#include <vector>
+#include "GameState.h"
+#include "PackedMove.h"
+#include "TranspositionTable.h"
+
+class Perft {
+public:
+    struct DivideEntry {
+        PackedMove move;
+        std::uint64_t nodes;
+    };
+
+    struct ReferencePosition {
+        const char *name;
+        const char *fen;
+        int depth;
+        std::uint64_t nodes;
+    };
+
+    // With a table, subtree counts are cached by position key and depth (hash perft).
+    static std::uint64_t run(GameState& state, int depth, TranspositionTable* tt = nullptr);
+
+    static std::uint64_t runParallel(const GameState& state, int depth, int threads,
+                                     TranspositionTable* tt = nullptr);
+
+    static std::vector<DivideEntry> divide(GameState& state, int depth, int threads = 1,
+                                           TranspositionTable* tt = nullptr);
+
+    static const std::vector<ReferencePosition>& referencePositions();
+
+private:
+    static std::vector<std::uint64_t> countPaths(const GameState& state,
+                                                 const std::vector<std::vector<PackedMove>>& paths,
+                                                 int depth, int threads, TranspositionTable* tt);
+};
+
+#endif //PERFT_H
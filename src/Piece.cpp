@@ -1,18 +1,6 @@
 #include "Piece.h"
 
-#include <locale>
-
-Piece::Piece(PieceType type, Color color) noexcept
-    : type_(type), color_(color) {
-}
-
-PieceType Piece::type() const noexcept {
-    return type_;
-}
-
-Color Piece::color() const noexcept {
-    return color_;
-}
+#include <cctype>
 
 char Piece::symbol() const noexcept {
     char c;
@@ -35,6 +23,19 @@ char Piece::symbol() const noexcept {
                : static_cast<char>(std::tolower(c));
 }
 
+std::optional<Piece> Piece::fromSymbol(char symbol) noexcept {
+    const Color color = std::isupper(static_cast<unsigned char>(symbol)) ? Color::White : Color::Black;
+    switch (std::tolower(static_cast<unsigned char>(symbol))) {
+        case 'k': return Piece(PieceType::King, color);
+        case 'q': return Piece(PieceType::Queen, color);
+        case 'r': return Piece(PieceType::Rook, color);
+        case 'b': return Piece(PieceType::Bishop, color);
+        case 'n': return Piece(PieceType::Knight, color);
+        case 'p': return Piece(PieceType::Pawn, color);
+        default: return std::nullopt;
+    }
+}
+
 int Piece::value() const noexcept {
     switch (type_) {
         case PieceType::King: return 0;
@@ -1,7 +1,10 @@
 #ifndef PIECE_H
 #define PIECE_H
 
-enum class PieceType {
+#include <cstdint>
+#include <optional>
+
+enum class PieceType : std::uint8_t {
     King,
     Queen,
     Rook,
@@ -10,21 +13,25 @@ enum class PieceType {
     Pawn
 };
 
-enum class Color {
+enum class Color : std::uint8_t {
     White,
     Black
 };
 
 class Piece {
 public:
-    Piece(PieceType type, Color color) noexcept;
+    constexpr Piece(PieceType type, Color color) noexcept
+        : type_(type), color_(color) {
+    }
 
-    PieceType type() const noexcept;
+    constexpr PieceType type() const noexcept { return type_; }
 
-    Color color() const noexcept;
+    constexpr Color color() const noexcept { return color_; }
 
     char symbol() const noexcept;
 
+    static std::optional<Piece> fromSymbol(char symbol) noexcept;
+
     int value() const noexcept;
 
 private:
@@ -0,0 +1,72 @@
+#include "San.h"
+#include "MoveGen.h"
+#include "MoveList.h"
+
+namespace {
+    char pieceLetter(PieceType type) {
+        switch (type) {
+            case PieceType::King: return 'K';
+            case PieceType::Queen: return 'Q';
+            case PieceType::Rook: return 'R';
+            case PieceType::Bishop: return 'B';
+            case PieceType::Knight: return 'N';
+            case PieceType::Pawn: return ' ';
+        }
+        return ' ';
+    }
+}
+
+std::string San::fromMove(const GameState &state, PackedMove move) {
+    const Board &board = state.board();
+    const auto moving = board.pieceAt(move.fromRow(), move.fromCol());
+    if (!moving) return {};
+
+    std::string san;
+    if (move.isCastling()) {
+        san = move.toCol() == 6 ? "O-O" : "O-O-O";
+    } else {
+        const bool capture = move.isEnPassant() || !board.isEmpty(move.to());
+        if (moving->type() == PieceType::Pawn) {
+            if (capture) san += static_cast<char>('a' + move.fromCol());
+        } else {
+            san += pieceLetter(moving->type());
+            // Name the file, else the rank, else both, of the piece when another of its kind can go there too.
+            MoveList moves;
+            MoveGenerator::generateLegal(state, moves);
+            bool ambiguous = false, sameFile = false, sameRank = false;
+            for (PackedMove other: moves) {
+                if (other.to() != move.to() || other.from() == move.from()) continue;
+                const auto piece = board.pieceAt(other.fromRow(), other.fromCol());
+                if (!piece || piece->type() != moving->type()) continue;
+                ambiguous = true;
+                sameFile |= other.fromCol() == move.fromCol();
+                sameRank |= other.fromRow() == move.fromRow();
+            }
+            if (ambiguous) {
+                if (!sameFile) san += static_cast<char>('a' + move.fromCol());
+                else if (!sameRank) san += static_cast<char>('1' + move.fromRow());
+                else {
+                    san += static_cast<char>('a' + move.fromCol());
+                    san += static_cast<char>('1' + move.fromRow());
+                }
+            }
+        }
+        if (capture) san += 'x';
+        san += static_cast<char>('a' + move.toCol());
+        san += static_cast<char>('1' + move.toRow());
+        if (move.isPromotion()) {
+            san += '=';
+            san += pieceLetter(move.promotionType());
+        }
+    }
+
+    GameState after = state;
+    GameState::UndoInfo undo;
+    after.makeMove(move, undo);
+    if (MoveGenerator::isInCheck(after.board(), after.sideToMove())) {
+        MoveList replies;
+        MoveGenerator::generateLegal(after, replies);
+        san += replies.empty() ? '#' : '+';
+    }
+    return san;
+}
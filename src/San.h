@@ -0,0 +1,16 @@
+#ifndef SAN_H
+#define SAN_H
+
+#include <string>
+#include "GameState.h"
+#include "PackedMove.h"
+
+// Standard algebraic notation, as used in move lists and PGN.
+class San {
+public:
+    // The move must be legal in the given position. Includes disambiguation, "=Q" for promotions
+    // and a trailing '+' or '#'.
+    static std::string fromMove(const GameState& state, PackedMove move);
+};
+
+#endif //SAN_H
@@ -0,0 +1,103 @@
+#include "TranspositionTable.h"
+#include <algorithm>
+
+TranspositionTable::TranspositionTable(std::size_t megabytes) {
+    resize(megabytes);
+}
+
+void TranspositionTable::resize(std::size_t megabytes) {
+    const std::size_t bytes = std::max<std::size_t>(megabytes, 1) * 1024 * 1024;
+    bucketCount_ = bytes / sizeof(Bucket);
+    buckets_ = std::make_unique<Bucket[]>(bucketCount_);
+    generation_ = 0;
+}
+
+void TranspositionTable::clear() noexcept {
+    for (std::size_t i = 0; i < bucketCount_; ++i) {
+        for (Slot &slot: buckets_[i].slots) {
+            slot.keyXorData.store(0, std::memory_order_relaxed);
+            slot.data.store(0, std::memory_order_relaxed);
+        }
+    }
+    generation_ = 0;
+}
+
+void TranspositionTable::newSearch() noexcept {
+    generation_ = (generation_ + 1) & 63;
+}
+
+TranspositionTable::Bucket &TranspositionTable::bucketFor(std::uint64_t key) const noexcept {
+    // High half of key * count spreads keys over any table size without a modulo.
+    const auto index = static_cast<std::size_t>((static_cast<unsigned __int128>(key) * bucketCount_) >> 64);
+    return buckets_[index];
+}
+
+bool TranspositionTable::probe(std::uint64_t key, Entry &entry) const noexcept {
+    const Bucket &bucket = bucketFor(key);
+    for (const Slot &slot: bucket.slots) {
+        const std::uint64_t data = slot.data.load(std::memory_order_relaxed);
+        const std::uint64_t check = slot.keyXorData.load(std::memory_order_relaxed);
+        if ((check ^ data) == key && Entry(data).bound() != Bound::None) {
+            entry = Entry(data);
+            return true;
+        }
+    }
+    return false;
+}
+
+void TranspositionTable::store(std::uint64_t key, int depth, Bound bound, PackedMove move, int score) noexcept {
+    const std::uint64_t payload = move.raw()
+                                  | static_cast<std::uint64_t>(static_cast<std::uint16_t>(score)) << 16;
+    write(key, depth, bound, payload);
+}
+
+void TranspositionTable::storeCount(std::uint64_t key, int depth, std::uint64_t count) noexcept {
+    write(key, depth, Bound::Exact, count & PAYLOAD_MASK);
+}
+
+void TranspositionTable::write(std::uint64_t key, int depth, Bound bound, std::uint64_t payload) noexcept {
+    Bucket &bucket = bucketFor(key);
+    Slot *target = nullptr;
+    int worst = 0;
+    for (Slot &slot: bucket.slots) {
+        const std::uint64_t data = slot.data.load(std::memory_order_relaxed);
+        const Entry old(data);
+        if (old.bound() != Bound::None && (slot.keyXorData.load(std::memory_order_relaxed) ^ data) == key) {
+            // Keep a deeper result for the same position unless it is from an older search.
+            if (bound != Bound::Exact && old.generation() == generation_ && old.depth() > depth + 2)
+                return;
+            target = &slot;
+            break;
+        }
+        // Depth-preferred, but entries from earlier searches lose 8 plies per generation of age.
+        const int age = (generation_ - old.generation()) & 63;
+        const int value = old.bound() == Bound::None ? -1024 : old.depth() - 8 * age;
+        if (!target || value < worst) {
+            target = &slot;
+            worst = value;
+        }
+    }
+
+    const std::uint64_t data = static_cast<std::uint64_t>(std::clamp(depth, 0, MAX_DEPTH)) << 56
+                               | static_cast<std::uint64_t>(generation_) << 50
+                               | static_cast<std::uint64_t>(bound) << 48
+                               | payload;
+    target->keyXorData.store(key ^ data, std::memory_order_relaxed);
+    target->data.store(data, std::memory_order_relaxed);
+}
+
+int TranspositionTable::hashfull() const noexcept {
+    const std::size_t sample = std::min<std::size_t>(bucketCount_, 250);
+    int used = 0;
+    for (std::size_t i = 0; i < sample; ++i) {
+        for (const Slot &slot: buckets_[i].slots) {
+            const Entry entry(slot.data.load(std::memory_order_relaxed));
+            if (entry.bound() != Bound::None && entry.generation() == generation_) ++used;
+        }
+    }
+    return sample == 0 ? 0 : static_cast<int>(used * 1000 / (sample * BUCKET_SIZE));
+}
+
+std::size_t TranspositionTable::sizeMegabytes() const noexcept {
+    return bucketCount_ * sizeof(Bucket) / (1024 * 1024);
+}
@@ -0,0 +1,91 @@
+#ifndef TRANSPOSITIONTABLE_H
+#define TRANSPOSITIONTABLE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "PackedMove.h"
+
+// Shared position cache keyed by GameState::key(). Entries are two 64-bit words written without locks;
+// the key is stored XORed with the data so a torn write from another thread fails verification.
+class TranspositionTable {
+public:
+    enum class Bound : std::uint8_t {
+        None,
+        Upper,
+        Lower,
+        Exact
+    };
+
+    static constexpr int MAX_DEPTH = 255;
+
+    class Entry {
+    public:
+        Entry() = default;
+
+        [[nodiscard]] int depth() const noexcept { return static_cast<int>(data_ >> 56); }
+        [[nodiscard]] Bound bound() const noexcept { return static_cast<Bound>((data_ >> 48) & 3); }
+        [[nodiscard]] int generation() const noexcept { return static_cast<int>((data_ >> 50) & 63); }
+
+        // Search payload.
+        [[nodiscard]] PackedMove move() const noexcept { return PackedMove::fromRaw(static_cast<std::uint16_t>(data_)); }
+        [[nodiscard]] int score() const noexcept { return static_cast<std::int16_t>(data_ >> 16); }
+
+        // Perft payload.
+        [[nodiscard]] std::uint64_t count() const noexcept { return data_ & PAYLOAD_MASK; }
+
+    private:
+        friend class TranspositionTable;
+
+        explicit Entry(std::uint64_t data) noexcept : data_(data) {}
+
+        std::uint64_t data_ = 0;
+    };
+
+    explicit TranspositionTable(std::size_t megabytes = 16);
+
+    TranspositionTable(const TranspositionTable&) = delete;
+    TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+    // Reallocates and clears; not safe while other threads are probing.
+    void resize(std::size_t megabytes);
+    void clear() noexcept;
+
+    // Ages existing entries so they are replaced first by the next search.
+    void newSearch() noexcept;
+
+    [[nodiscard]] bool probe(std::uint64_t key, Entry& entry) const noexcept;
+
+    void store(std::uint64_t key, int depth, Bound bound, PackedMove move, int score) noexcept;
+    void storeCount(std::uint64_t key, int depth, std::uint64_t count) noexcept;
+
+    // Share of the table filled during the current search, in permille (UCI "hashfull").
+    [[nodiscard]] int hashfull() const noexcept;
+
+    [[nodiscard]] std::size_t sizeMegabytes() const noexcept;
+
+private:
+    static constexpr std::uint64_t PAYLOAD_MASK = (std::uint64_t{1} << 48) - 1;
+    static constexpr int BUCKET_SIZE = 4;
+
+    struct Slot {
+        std::atomic<std::uint64_t> keyXorData{0};
+        std::atomic<std::uint64_t> data{0};
+    };
+
+    struct alignas(64) Bucket {
+        Slot slots[BUCKET_SIZE];
+    };
+
+    static_assert(sizeof(Bucket) == 64, "a bucket must fill exactly one cache line");
+
+    [[nodiscard]] Bucket& bucketFor(std::uint64_t key) const noexcept;
+    void write(std::uint64_t key, int depth, Bound bound, std::uint64_t payload) noexcept;
+
+    std::unique_ptr<Bucket[]> buckets_;
+    std::size_t bucketCount_ = 0;
+    std::uint8_t generation_ = 0;
+};
+
+#endif //TRANSPOSITIONTABLE_H
@@ -0,0 +1,41 @@
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include <cstdint>
+#include "Piece.h"
+
+namespace Zobrist {
+    struct Keys {
+        std::uint64_t pieces[2][6][64];
+        std::uint64_t castling[16];
+        std::uint64_t enPassantFile[8];
+        std::uint64_t side;
+    };
+
+    // Generated at compile time (splitmix64) so no static-initialization order can observe empty keys.
+    constexpr Keys makeKeys() {
+        Keys keys{};
+        std::uint64_t state = 0x9E3779B97F4A7C15ULL;
+        auto next = [&state] {
+            std::uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            return z ^ (z >> 31);
+        };
+        for (auto &color: keys.pieces)
+            for (auto &type: color)
+                for (auto &sq: type) sq = next();
+        for (auto &c: keys.castling) c = next();
+        for (auto &f: keys.enPassantFile) f = next();
+        keys.side = next();
+        return keys;
+    }
+
+    inline constexpr Keys KEYS = makeKeys();
+
+    constexpr std::uint64_t piece(Piece piece, int sq) noexcept {
+        return KEYS.pieces[static_cast<int>(piece.color())][static_cast<int>(piece.type())][sq];
+    }
+}
+
+#endif //ZOBRIST_H
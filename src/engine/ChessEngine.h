@@ -0,0 +1,62 @@
+#ifndef CHESSENGINE_H
+#define CHESSENGINE_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include "UciInfoCoalescer.h"
+
+// Common interface of the external UCI process and the built-in search, so the board widget can drive either.
+class ChessEngine : public QObject {
+    Q_OBJECT
+public:
+    explicit ChessEngine(QObject* parent = nullptr)
+        : QObject(parent) {
+        connect(&infoCoalescer_, &UciInfoCoalescer::ready, this, &ChessEngine::searchInfo);
+    }
+    ~ChessEngine() override = default;
+
+    // Minimum spacing of searchInfo updates for the same multipv line.
+    void setInfoInterval(int ms) { infoCoalescer_.setInterval(ms); }
+
+    virtual void start(const QString& enginePath) = 0;
+    virtual void quit() = 0;
+    virtual bool isRunning() const = 0;
+    // True until the engine has answered the handshake and every isready sent since.
+    virtual bool awaitingReady() const = 0;
+
+    virtual void newGame() = 0;
+    virtual void setOption(const QString& name, const QString& value) = 0;
+    virtual void setDifficultyElo(int elo, bool limitStrength = true) = 0;
+
+    virtual void setPositionFEN(const QString& fen, const QStringList& uciMoves = {}) = 0;
+    virtual void setPositionFromStartpos(const QStringList& uciMoves) = 0;
+
+    virtual void goDepth(int depth) = 0;
+    virtual void goMovetime(int ms) = 0;
+    // Searches until stop(); used for analysis.
+    virtual void goInfinite() = 0;
+    // movesToGo 0 means sudden death.
+    virtual void goClock(int wtimeMs, int btimeMs, int wincMs = 0, int bincMs = 0, int movesToGo = 0) = 0;
+
+    // Thinks on the opponent's time: the position set last must already contain the expected reply.
+    // Nothing is reported until ponderHit(); a ponder search ended by stop() never reports bestMove.
+    virtual void goPonder(int wtimeMs, int btimeMs, int wincMs = 0, int bincMs = 0, int movesToGo = 0) = 0;
+    virtual void ponderHit() = 0;
+    virtual void stop() = 0;
+
+signals:
+    void engineReady();
+    void bestMove(const QString& uciMove, const QString& ponder);
+    // Decoded and throttled search progress.
+    void searchInfo(const UciInfo& info);
+    // Other engine output, e.g. "info string" lines.
+    void info(const QString& line);
+    void errorText(const QString& message);
+    void engineBanner(const QString& name, const QString& author);
+
+protected:
+    UciInfoCoalescer infoCoalescer_;
+};
+
+#endif // CHESSENGINE_H
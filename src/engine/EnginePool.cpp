@@ -0,0 +1,91 @@
+#include "EnginePool.h"
+#include "LocalEngine.h"
+#include "StockFishClient.h"
+#include <QCoreApplication>
+#include <QFileInfo>
+#include <QTimer>
+
+namespace {
+    const QString STOCKFISH_PATH = QStringLiteral("/usr/bin/stockfish");
+}
+
+EnginePool::EnginePool(QObject *parent)
+    : QObject(parent) {
+}
+
+EnginePool &EnginePool::instance() {
+    static EnginePool *pool = new EnginePool(QCoreApplication::instance());
+    return *pool;
+}
+
+QString EnginePool::enginePath() {
+    return STOCKFISH_PATH;
+}
+
+void EnginePool::setCapacity(int engines) {
+    capacity_ = qMax(0, engines);
+    while (idle_.size() + resetting_.size() > capacity_ && !idle_.isEmpty())
+        retire(idle_.takeLast());
+}
+
+int EnginePool::capacity() const noexcept {
+    return capacity_;
+}
+
+void EnginePool::warmUp() {
+    // An engine that died while parked would otherwise be handed out or wait for readyok forever.
+    for (ChessEngine *engine: QList<ChessEngine *>(resetting_) + idle_) {
+        if (!engine->isRunning()) retire(engine);
+    }
+    while (idle_.size() + resetting_.size() < capacity_)
+        idle_ << createEngine();
+}
+
+ChessEngine *EnginePool::acquire() {
+    ChessEngine *engine = idle_.isEmpty() ? createEngine() : idle_.takeFirst();
+    if (!engine->isRunning()) engine->start(enginePath());
+    // Replace the leased engine in the background so that the next game finds one warm as well.
+    QTimer::singleShot(0, this, &EnginePool::warmUp);
+    return engine;
+}
+
+void EnginePool::release(ChessEngine *engine) {
+    if (!engine) return;
+    engine->disconnect();
+    if (!engine->isRunning() || idle_.size() + resetting_.size() >= capacity_) {
+        retire(engine);
+        return;
+    }
+    engine->stop();
+    // Analysis may have widened the search or lifted the strength limit; games expect neither.
+    engine->setOption("MultiPV", "1");
+    engine->setOption("UCI_LimitStrength", "false");
+    engine->newGame();
+    resetting_ << engine;
+    // Anything the engine still had to say about the old game arrives before the readyok that answers
+    // newGame(). An engine leased mid-handshake sends another readyok first, which must not count.
+    connect(engine, &ChessEngine::engineReady, this, [this, engine] {
+        if (engine->awaitingReady() || !resetting_.removeOne(engine)) return;
+        engine->disconnect(this);
+        idle_ << engine;
+    });
+}
+
+ChessEngine *EnginePool::createEngine() {
+    // Without an installed Stockfish the built-in search plays instead.
+    ChessEngine *engine = nullptr;
+    if (QFileInfo::exists(STOCKFISH_PATH))
+        engine = new StockfishClient(this);
+    else
+        engine = new LocalEngine(this);
+    engine->start(STOCKFISH_PATH);
+    return engine;
+}
+
+void EnginePool::retire(ChessEngine *engine) {
+    idle_.removeOne(engine);
+    resetting_.removeOne(engine);
+    engine->disconnect(this);
+    engine->quit();
+    engine->deleteLater();
+}
@@ -0,0 +1,45 @@
+#ifndef ENGINEPOOL_H
+#define ENGINEPOOL_H
+
+#include "ChessEngine.h"
+#include <QList>
+#include <QObject>
+#include <QString>
+
+// Keeps engines started, handshaken and with their hash allocated, so a new game does not pay for
+// spawning a process. Boards lease an engine for their lifetime and hand it back when they close;
+// a returned engine is stopped and reset with newGame() before anyone else gets it.
+class EnginePool : public QObject {
+    Q_OBJECT
+public:
+    // Owned by the application object.
+    static EnginePool& instance();
+
+    // Stockfish when it is installed, the built-in engine otherwise.
+    static QString enginePath();
+
+    // Number of idle engines kept warm; surplus engines are shut down when returned.
+    void setCapacity(int engines);
+    [[nodiscard]] int capacity() const noexcept;
+
+    // Starts engines until capacity() of them are idle or resetting.
+    void warmUp();
+
+    // The caller uses the engine until release(); it stays owned by the pool.
+    ChessEngine* acquire();
+    // Disconnects everything the lessee attached to the engine and recycles it.
+    void release(ChessEngine* engine);
+
+private:
+    explicit EnginePool(QObject* parent);
+
+    ChessEngine* createEngine();
+    void retire(ChessEngine* engine);
+
+    int capacity_ = 1;
+    QList<ChessEngine*> idle_;
+    // Returned engines waiting for the readyok that follows their reset.
+    QList<ChessEngine*> resetting_;
+};
+
+#endif // ENGINEPOOL_H
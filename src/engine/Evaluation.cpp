@@ -0,0 +1,23 @@
+#include "Evaluation.h"
+#include <algorithm>
+
+int Evaluation::taper(Psqt::Score score, int phase) noexcept {
+    const int mg = std::min(phase, Psqt::MAX_PHASE);
+    return (score.mg * mg + score.eg * (Psqt::MAX_PHASE - mg)) / Psqt::MAX_PHASE;
+}
+
+int Evaluation::evaluate(const GameState &state) {
+    return finish(state, PawnStructure::evaluate(state.board()));
+}
+
+int Evaluation::evaluate(const GameState &state, PawnCache &pawns) {
+    return finish(state, pawns.evaluate(state.board()));
+}
+
+int Evaluation::finish(const GameState &state, Psqt::Score score) {
+    // Material and piece-square terms are maintained by Board on every make/unmake.
+    const Board &board = state.board();
+    score += board.psq();
+    const int total = taper(score, board.phase());
+    return state.sideToMove() == Color::White ? total : -total;
+}
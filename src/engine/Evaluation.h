@@ -0,0 +1,23 @@
+#ifndef EVALUATION_H
+#define EVALUATION_H
+
+#include "../GameState.h"
+#include "../Psqt.h"
+#include "PawnStructure.h"
+
+class Evaluation {
+public:
+    // Static evaluation in centipawns from the side to move's point of view.
+    static int evaluate(const GameState& state);
+
+    // Same, with pawn-structure terms taken from the calling thread's cache.
+    static int evaluate(const GameState& state, PawnCache& pawns);
+
+    // Blends midgame and endgame scores by the remaining material.
+    static int taper(Psqt::Score score, int phase) noexcept;
+
+private:
+    static int finish(const GameState& state, Psqt::Score score);
+};
+
+#endif //EVALUATION_H
@@ -0,0 +1,230 @@
+#include "LocalEngine.h"
+#include "../MoveGen.h"
+#include <QMetaObject>
+#include <QThread>
+#include <QTimer>
+#include <QtGlobal>
+
+LocalEngine::LocalEngine(QObject *parent)
+    : ChessEngine(parent)
+      , tt_(128)
+      , search_(tt_) {
+}
+
+LocalEngine::~LocalEngine() {
+    quit();
+}
+
+void LocalEngine::start(const QString &) {
+    joinSearch();
+    running_ = true;
+    resetPosition();
+    setOption("Threads", QString::number(qMax(1, QThread::idealThreadCount())));
+    ++readyPending_;
+    QTimer::singleShot(0, this, [this] {
+        --readyPending_;
+        emit engineBanner("GameOfChess", QString());
+        emit engineReady();
+    });
+}
+
+void LocalEngine::quit() {
+    joinSearch();
+    running_ = false;
+}
+
+bool LocalEngine::isRunning() const {
+    return running_;
+}
+
+bool LocalEngine::awaitingReady() const {
+    return readyPending_ > 0;
+}
+
+void LocalEngine::newGame() {
+    joinSearch();
+    resetPosition();
+    tt_.clear();
+    ++readyPending_;
+    QTimer::singleShot(0, this, [this] {
+        --readyPending_;
+        emit engineReady();
+    });
+}
+
+void LocalEngine::setOption(const QString &name, const QString &value) {
+    bool ok = false;
+    const int number = value.toInt(&ok);
+    if (!ok) return;
+    if (name == "Threads") {
+        joinSearch();
+        search_.setThreads(qBound(1, number, 1024));
+    } else if (name == "Hash") {
+        joinSearch();
+        tt_.resize(static_cast<std::size_t>(qMax(1, number)));
+    } else if (name == "MultiPV") {
+        multiPv_ = qBound(1, number, 256);
+    }
+}
+
+void LocalEngine::setDifficultyElo(int elo, bool limitStrength) {
+    depthLimit_ = limitStrength ? Search::depthForElo(elo) : Search::MAX_PLY - 1;
+}
+
+void LocalEngine::setPositionFEN(const QString &fen, const QStringList &uciMoves) {
+    joinSearch();
+    auto state = GameState::fromFEN(fen.toStdString());
+    if (!state) {
+        emit errorText(QString("Некорректная позиция: %1").arg(fen));
+        return;
+    }
+    position_ = *state;
+    positionMoves_.clear();
+    fromStartpos_ = false;
+    applyUciMoves(uciMoves);
+}
+
+void LocalEngine::setPositionFromStartpos(const QStringList &uciMoves) {
+    joinSearch();
+    if (!fromStartpos_) resetPosition();
+    // Take back only what differs from the game we already hold and play the rest, so history
+    // (and with it repetition detection) carries over without replaying the whole game.
+    qsizetype common = 0;
+    while (common < positionMoves_.size() && common < uciMoves.size()
+           && positionMoves_[common] == uciMoves[common])
+        ++common;
+    while (positionMoves_.size() > common) {
+        position_.undoMove();
+        positionMoves_.removeLast();
+    }
+    applyUciMoves(uciMoves.mid(common));
+}
+
+void LocalEngine::goDepth(int depth) {
+    Search::Limits limits;
+    limits.maxDepth = qMin(depth, depthLimit_);
+    startSearch(limits);
+}
+
+void LocalEngine::goMovetime(int ms) {
+    Search::Limits limits;
+    limits.maxDepth = depthLimit_;
+    limits.movetimeMs = qMax(1, ms);
+    startSearch(limits);
+}
+
+void LocalEngine::goInfinite() {
+    Search::Limits limits;
+    limits.maxDepth = depthLimit_;
+    startSearch(limits);
+}
+
+void LocalEngine::goClock(int wtimeMs, int btimeMs, int wincMs, int bincMs, int movesToGo) {
+    startSearch(clockLimits(wtimeMs, btimeMs, wincMs, bincMs, movesToGo));
+}
+
+void LocalEngine::goPonder(int wtimeMs, int btimeMs, int wincMs, int bincMs, int movesToGo) {
+    Search::Limits limits;
+    limits.maxDepth = depthLimit_;
+    startSearch(limits, true);
+    ponderLimits_ = clockLimits(wtimeMs, btimeMs, wincMs, bincMs, movesToGo);
+}
+
+void LocalEngine::ponderHit() {
+    if (!pondering_) return;
+    startSearch(ponderLimits_);
+}
+
+void LocalEngine::stop() {
+    if (pondering_) {
+        joinSearch();
+        pondering_ = false;
+        return;
+    }
+    // Like a UCI engine, report the stopped search before taking the next command, so that every
+    // stopped search is answered by exactly one bestMove.
+    search_.stop();
+    search_.wait();
+}
+
+Search::Limits LocalEngine::clockLimits(int wtimeMs, int btimeMs, int wincMs, int bincMs, int movesToGo) const {
+    const bool white = position_.sideToMove() == Color::White;
+    Search::Limits limits;
+    limits.maxDepth = depthLimit_;
+    limits.clock.remainingMs = qMax(1, white ? wtimeMs : btimeMs);
+    limits.clock.incrementMs = white ? wincMs : bincMs;
+    limits.clock.movesToGo = movesToGo;
+    return limits;
+}
+
+void LocalEngine::resetPosition() {
+    position_ = GameState();
+    positionMoves_.clear();
+    fromStartpos_ = true;
+}
+
+void LocalEngine::applyUciMoves(const QStringList &uciMoves) {
+    for (const QString &uci: uciMoves) {
+        auto move = Move::fromUCIInPosition(uci.toStdString(), position_);
+        if (!move) {
+            emit errorText(QString("Некорректный ход: %1").arg(uci));
+            return;
+        }
+        position_.applyMove(*move);
+        positionMoves_ << uci;
+    }
+}
+
+void LocalEngine::startSearch(Search::Limits limits, bool ponder) {
+    joinSearch();
+    pondering_ = ponder;
+    lastPv_.clear();
+    limits.multiPv = multiPv_;
+    const quint64 id = searchId_;
+    search_.start(position_, limits, [this, id](const Search::Info &info) {
+        QMetaObject::invokeMethod(this, [this, id, info = toUciInfo(info)]() mutable {
+            if (id != searchId_) return;
+            if (info.multiPv == 1) lastPv_ = info.pv;
+            infoCoalescer_.push(std::move(info));
+        }, Qt::QueuedConnection);
+    }, [this, id](PackedMove best) {
+        QMetaObject::invokeMethod(this, [this, id, best] {
+            if (id != searchId_ || pondering_) return;
+            infoCoalescer_.flush();
+            const QString uci = best ? QString::fromStdString(best.toUCI()) : QString("(none)");
+            // The expected reply is the second move of the line the best move came from.
+            const QString ponder = lastPv_.size() > 1 && lastPv_.front() == best
+                                       ? QString::fromStdString(lastPv_[1].toUCI())
+                                       : QString();
+            emit bestMove(uci, ponder);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void LocalEngine::joinSearch() {
+    if (!search_.isSearching()) return;
+    // A search abandoned by a new command must not report; an explicit stop() still does.
+    ++searchId_;
+    search_.stop();
+    search_.wait();
+}
+
+UciInfo LocalEngine::toUciInfo(const Search::Info &info) {
+    UciInfo uci;
+    uci.depth = info.depth;
+    uci.selDepth = info.depth;
+    uci.hasScore = true;
+    uci.isMate = Search::isMateScore(info.score);
+    uci.score = uci.isMate ? Search::mateInMoves(info.score) : info.score;
+    uci.nodes = info.nodes;
+    uci.nps = info.timeMs > 0 ? info.nodes * 1000 / static_cast<std::uint64_t>(info.timeMs) : 0;
+    uci.hashfull = info.hashfull;
+    uci.multiPv = info.multiPv;
+    uci.timeMs = info.timeMs;
+    // Same contract as a parsed line: castling and en passant flags are left to the receiver.
+    uci.pv.reserve(info.pv.size());
+    for (PackedMove move: info.pv) {
+        uci.pv.push_back(move.isPromotion() ? move : PackedMove(move.from(), move.to()));
+    }
+    return uci;
+}
@@ -0,0 +1,66 @@
+#ifndef LOCALENGINE_H
+#define LOCALENGINE_H
+
+#include "ChessEngine.h"
+#include "ParallelSearch.h"
+#include "../GameState.h"
+#include "../TranspositionTable.h"
+
+// Built-in alpha-beta engine; searches on worker threads and answers with the same signals as the UCI client.
+class LocalEngine : public ChessEngine {
+    Q_OBJECT
+public:
+    explicit LocalEngine(QObject* parent = nullptr);
+    ~LocalEngine() override;
+
+    void start(const QString& enginePath) override;
+    void quit() override;
+    bool isRunning() const override;
+    bool awaitingReady() const override;
+
+    void newGame() override;
+
+    // Understands the UCI options "Threads", "Hash" (MB) and "MultiPV".
+    void setOption(const QString& name, const QString& value) override;
+    void setDifficultyElo(int elo, bool limitStrength = true) override;
+
+    void setPositionFEN(const QString& fen, const QStringList& uciMoves = {}) override;
+    void setPositionFromStartpos(const QStringList& uciMoves) override;
+
+    void goDepth(int depth) override;
+    void goMovetime(int ms) override;
+    void goInfinite() override;
+    void goClock(int wtimeMs, int btimeMs, int wincMs = 0, int bincMs = 0, int movesToGo = 0) override;
+    void goPonder(int wtimeMs, int btimeMs, int wincMs = 0, int bincMs = 0, int movesToGo = 0) override;
+    void ponderHit() override;
+    void stop() override;
+
+private:
+    void resetPosition();
+    void applyUciMoves(const QStringList& uciMoves);
+    [[nodiscard]] Search::Limits clockLimits(int wtimeMs, int btimeMs, int wincMs, int bincMs, int movesToGo) const;
+    void startSearch(Search::Limits limits, bool ponder = false);
+    void joinSearch();
+    static UciInfo toUciInfo(const Search::Info& info);
+
+    GameState position_;
+    // Moves played on top of the start position (or the last FEN) to reach position_.
+    QStringList positionMoves_;
+    bool fromStartpos_ = true;
+    TranspositionTable tt_;
+    ParallelSearch search_;
+    quint64 searchId_ = 0;
+    int depthLimit_ = Search::MAX_PLY - 1;
+    int multiPv_ = 1;
+    // While pondering the search runs unlimited; on a hit it is restarted on these limits and
+    // finishes quickly from the table the ponder search has filled.
+    bool pondering_ = false;
+    Search::Limits ponderLimits_;
+    // Last reported principal variation, for bestMove's ponder argument.
+    std::vector<PackedMove> lastPv_;
+    bool running_ = false;
+    // engineReady signals queued but not yet emitted.
+    int readyPending_ = 0;
+};
+
+#endif // LOCALENGINE_H
@@ -0,0 +1,82 @@
+#include "ParallelSearch.h"
+#include <algorithm>
+
+ParallelSearch::ParallelSearch(TranspositionTable &tt, int threads)
+    : tt_(tt) {
+    setThreads(threads);
+}
+
+ParallelSearch::~ParallelSearch() {
+    stop();
+    wait();
+}
+
+void ParallelSearch::setThreads(int threads) {
+    searches_.clear();
+    const int count = std::max(1, threads);
+    for (int i = 0; i < count; ++i) {
+        searches_.push_back(std::make_unique<Search>(tt_, &stop_, i));
+    }
+}
+
+int ParallelSearch::threads() const noexcept {
+    return static_cast<int>(searches_.size());
+}
+
+void ParallelSearch::start(const GameState &root, const Search::Limits &limits,
+                           Search::InfoCallback onInfo, DoneCallback onDone) {
+    wait();
+    // Reset before any thread exists, so a stop() issued right after start() cannot be lost.
+    stop_ = false;
+    tt_.newSearch();
+
+    Search::Limits helperLimits;
+    helperLimits.maxDepth = Search::MAX_PLY - 1;
+    for (std::size_t i = 1; i < searches_.size(); ++i) {
+        helpers_.emplace_back([this, i, root, helperLimits] {
+            searches_[i]->think(root, helperLimits);
+        });
+    }
+
+    main_ = std::jthread([this, root, limits, onInfo = std::move(onInfo), onDone = std::move(onDone)] {
+        Search::InfoCallback report;
+        if (onInfo) {
+            report = [this, &onInfo](const Search::Info &info) {
+                Search::Info total = info;
+                total.nodes = nodes();
+                onInfo(total);
+            };
+        }
+        const PackedMove best = searches_[0]->think(root, limits, report);
+        stop_ = true;
+        for (auto &helper: helpers_) helper.join();
+        helpers_.clear();
+        if (onDone) onDone(best);
+    });
+}
+
+void ParallelSearch::stop() noexcept {
+    stop_ = true;
+}
+
+void ParallelSearch::wait() {
+    if (main_.joinable()) main_.join();
+}
+
+bool ParallelSearch::isSearching() const noexcept {
+    return main_.joinable();
+}
+
+PackedMove ParallelSearch::think(const GameState &root, const Search::Limits &limits,
+                                 const Search::InfoCallback &onInfo) {
+    PackedMove best;
+    start(root, limits, onInfo, [&best](PackedMove move) { best = move; });
+    wait();
+    return best;
+}
+
+std::uint64_t ParallelSearch::nodes() const noexcept {
+    std::uint64_t total = 0;
+    for (const auto &search: searches_) total += search->nodes();
+    return total;
+}
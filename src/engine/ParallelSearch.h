@@ -0,0 +1,51 @@
+#ifndef PARALLELSEARCH_H
+#define PARALLELSEARCH_H
+
+#include "Search.h"
+#include "../GameState.h"
+#include "../TranspositionTable.h"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// Lazy SMP: every thread runs its own iterative deepening on the same root and they cooperate only
+// through the shared transposition table. The main thread's result is the one reported.
+class ParallelSearch {
+public:
+    using DoneCallback = std::function<void(PackedMove)>;
+
+    explicit ParallelSearch(TranspositionTable& tt, int threads = 1);
+    ~ParallelSearch();
+
+    ParallelSearch(const ParallelSearch&) = delete;
+    ParallelSearch& operator=(const ParallelSearch&) = delete;
+
+    // Must not be called while a search is running.
+    void setThreads(int threads);
+    [[nodiscard]] int threads() const noexcept;
+
+    // Returns immediately; onInfo and onDone are invoked from the search's main thread.
+    void start(const GameState& root, const Search::Limits& limits,
+               Search::InfoCallback onInfo, DoneCallback onDone);
+    void stop() noexcept;
+    void wait();
+    [[nodiscard]] bool isSearching() const noexcept;
+
+    // Blocking convenience wrapper around start() and wait().
+    PackedMove think(const GameState& root, const Search::Limits& limits,
+                     const Search::InfoCallback& onInfo = {});
+
+    // Sum over all threads.
+    [[nodiscard]] std::uint64_t nodes() const noexcept;
+
+private:
+    TranspositionTable& tt_;
+    std::atomic<bool> stop_{false};
+    std::vector<std::unique_ptr<Search>> searches_;
+    std::vector<std::jthread> helpers_;
+    std::jthread main_;
+};
+
+#endif //PARALLELSEARCH_H
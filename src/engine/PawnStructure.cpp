@@ -0,0 +1,137 @@
+#include "PawnStructure.h"
+#include <algorithm>
+#include <bit>
+
+namespace {
+    constexpr Psqt::Score ISOLATED{-5, -15};
+    constexpr Psqt::Score DOUBLED{-10, -25};
+    constexpr Psqt::Score BACKWARD{-9, -12};
+    // Indexed by rank from the pawn owner's side.
+    constexpr Psqt::Score PASSED[8] = {{0, 0}, {3, 10}, {6, 15}, {12, 25}, {25, 50}, {45, 90}, {70, 140}, {0, 0}};
+    // Per pawn directly in front of the king and one rank further.
+    constexpr int SHIELD_NEAR = 14;
+    constexpr int SHIELD_FAR = 7;
+
+    Bitboard adjacentFiles(int col) {
+        return (col > 0 ? bb::fileBB(col - 1) : 0) | (col < 7 ? bb::fileBB(col + 1) : 0);
+    }
+
+    // Ranks strictly ahead of row from color's point of view.
+    Bitboard ranksAhead(Color color, int row) {
+        if (color == Color::White) return row >= 7 ? 0 : ~Bitboard{0} << (8 * (row + 1));
+        return (Bitboard{1} << (8 * row)) - 1;
+    }
+
+    Bitboard pawnAttacksOf(Color color, Bitboard pawns) {
+        return color == Color::White
+                   ? ((pawns & ~bb::FILE_A) << 7) | ((pawns & ~bb::FILE_H) << 9)
+                   : ((pawns & ~bb::FILE_A) >> 9) | ((pawns & ~bb::FILE_H) >> 7);
+    }
+
+    Psqt::Score evaluateSide(const Board &board, Color us, Bitboard &passed) {
+        const Color them = us == Color::White ? Color::Black : Color::White;
+        const Bitboard ours = board.pieces(us, PieceType::Pawn);
+        const Bitboard theirs = board.pieces(them, PieceType::Pawn);
+        const Bitboard theirAttacks = pawnAttacksOf(them, theirs);
+        const int push = us == Color::White ? 8 : -8;
+
+        Psqt::Score score;
+        passed = 0;
+        Bitboard pawns = ours;
+        while (pawns) {
+            const int sq = bb::popLsb(pawns);
+            const int row = bb::rowOf(sq), col = bb::colOf(sq);
+            const Bitboard ahead = ranksAhead(us, row);
+            const Bitboard neighbours = ours & adjacentFiles(col);
+
+            if (!(theirs & (bb::fileBB(col) | adjacentFiles(col)) & ahead)
+                && !(ours & bb::fileBB(col) & ahead)) {
+                passed |= bb::squareBB(sq);
+                score += PASSED[us == Color::White ? row : 7 - row];
+            }
+            if (!neighbours) {
+                score += ISOLATED;
+            } else if (!(neighbours & ~ahead) && sq + push >= 0 && sq + push < 64
+                       && (theirAttacks & bb::squareBB(sq + push))) {
+                // No friendly pawn level or behind can ever defend it, and its advance is covered.
+                score += BACKWARD;
+            }
+            if (ours & bb::fileBB(col) & ahead) score += DOUBLED;
+        }
+        return score;
+    }
+
+    int shieldFor(const Board &board, Color us) {
+        const int king = board.kingSquare(us);
+        if (king < 0) return 0;
+        const int row = bb::rowOf(king), col = bb::colOf(king);
+        const int dir = us == Color::White ? 1 : -1;
+        const Bitboard files = bb::fileBB(col) | adjacentFiles(col);
+        const Bitboard ours = board.pieces(us, PieceType::Pawn) & files;
+        int shield = 0;
+        if (row + dir >= 0 && row + dir < 8) shield += SHIELD_NEAR * bb::popCount(ours & bb::rankBB(row + dir));
+        if (row + 2 * dir >= 0 && row + 2 * dir < 8)
+            shield += SHIELD_FAR * bb::popCount(ours & bb::rankBB(row + 2 * dir));
+        return shield;
+    }
+}
+
+Psqt::Score PawnStructure::evaluatePawns(const Board &board, Bitboard passed[2]) {
+    Psqt::Score score = evaluateSide(board, Color::White, passed[0]);
+    score -= evaluateSide(board, Color::Black, passed[1]);
+    return score;
+}
+
+Psqt::Score PawnStructure::evaluateShield(const Board &board) {
+    // Only a midgame term: in the endgame the king should leave its pawns.
+    return {shieldFor(board, Color::White) - shieldFor(board, Color::Black), 0};
+}
+
+Psqt::Score PawnStructure::evaluate(const Board &board) {
+    Bitboard passed[2];
+    Psqt::Score score = evaluatePawns(board, passed);
+    score += evaluateShield(board);
+    return score;
+}
+
+PawnCache::PawnCache(std::size_t entries)
+    : entries_(std::make_unique<PawnStructure::Entry[]>(std::bit_ceil(std::max<std::size_t>(entries, 1))))
+      , mask_(std::bit_ceil(std::max<std::size_t>(entries, 1)) - 1) {
+}
+
+Psqt::Score PawnCache::evaluate(const Board &board) {
+    const std::uint64_t key = board.pawnKey();
+    PawnStructure::Entry &entry = entries_[key & mask_];
+    ++probes_;
+    if (entry.valid && entry.key == key) {
+        ++hits_;
+    } else {
+        entry.key = key;
+        entry.pawns = PawnStructure::evaluatePawns(board, entry.passed);
+        entry.kingSquares[0] = entry.kingSquares[1] = -1;
+        entry.valid = true;
+    }
+
+    const int whiteKing = board.kingSquare(Color::White), blackKing = board.kingSquare(Color::Black);
+    if (entry.kingSquares[0] != whiteKing || entry.kingSquares[1] != blackKing) {
+        entry.kingSquares[0] = whiteKing;
+        entry.kingSquares[1] = blackKing;
+        entry.shield = PawnStructure::evaluateShield(board);
+    }
+    Psqt::Score score = entry.pawns;
+    score += entry.shield;
+    return score;
+}
+
+void PawnCache::clear() noexcept {
+    for (std::size_t i = 0; i <= mask_; ++i) entries_[i] = PawnStructure::Entry{};
+    probes_ = hits_ = 0;
+}
+
+std::uint64_t PawnCache::probes() const noexcept {
+    return probes_;
+}
+
+std::uint64_t PawnCache::hits() const noexcept {
+    return hits_;
+}
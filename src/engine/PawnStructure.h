@@ -0,0 +1,53 @@
+#ifndef PAWNSTRUCTURE_H
+#define PAWNSTRUCTURE_H
+
+#include "../Bitboard.h"
+#include "../Board.h"
+#include "../Psqt.h"
+#include <cstdint>
+#include <memory>
+
+// Pawn-structure terms: passed, isolated, doubled and backward pawns, plus the pawn shield in front
+// of each king. Scores are from White's point of view.
+class PawnStructure {
+public:
+    struct Entry {
+        std::uint64_t key = 0;
+        Psqt::Score pawns;
+        Bitboard passed[2] = {0, 0};
+        // The shield also depends on where the kings stand, so it is cached separately.
+        int kingSquares[2] = {-1, -1};
+        Psqt::Score shield;
+        bool valid = false;
+    };
+
+    // Structure terms only; depends on nothing but the pawns.
+    static Psqt::Score evaluatePawns(const Board& board, Bitboard passed[2]);
+
+    static Psqt::Score evaluateShield(const Board& board);
+
+    // Both parts combined, without caching.
+    static Psqt::Score evaluate(const Board& board);
+};
+
+// Small per-thread cache of PawnStructure entries keyed by Board::pawnKey(); not thread-safe.
+class PawnCache {
+public:
+    explicit PawnCache(std::size_t entries = 16384);
+
+    // Structure + shield for the board, reusing whatever is still valid.
+    Psqt::Score evaluate(const Board& board);
+
+    void clear() noexcept;
+
+    [[nodiscard]] std::uint64_t probes() const noexcept;
+    [[nodiscard]] std::uint64_t hits() const noexcept;
+
+private:
+    std::unique_ptr<PawnStructure::Entry[]> entries_;
+    std::size_t mask_;
+    std::uint64_t probes_ = 0;
+    std::uint64_t hits_ = 0;
+};
+
+#endif //PAWNSTRUCTURE_H
@@ -0,0 +1,258 @@
+#include "Search.h"
+#include "Evaluation.h"
+#include "../MoveGen.h"
+#include "../MovePicker.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+    bool isQuiet(const Board &board, PackedMove move) {
+        return !move.isEnPassant() && !move.isPromotion() && board.isEmpty(move.to());
+    }
+}
+
+Search::Search(TranspositionTable &tt, const std::atomic<bool> *sharedStop, int threadIndex)
+    : tt_(tt)
+      , sharedStop_(sharedStop)
+      , threadIndex_(threadIndex) {
+}
+
+PackedMove Search::think(const GameState &root, const Limits &limits, const InfoCallback &onInfo) {
+    state_ = root;
+    limits_ = limits;
+    stopped_ = false;
+    nodes_ = 0;
+    start_ = std::chrono::steady_clock::now();
+    previousPv_.clear();
+    heuristics_.clear();
+
+    MoveList rootMoves;
+    MoveGenerator::generateLegal(state_, rootMoves);
+    if (rootMoves.empty()) return {};
+
+    const bool managed = limits.movetimeMs <= 0 && limits.clock.remainingMs > 0;
+    if (managed) {
+        timeManager_.init(limits.clock);
+        limits_.movetimeMs = static_cast<int>(timeManager_.maximumMs());
+    }
+
+    PackedMove best = rootMoves[0];
+    const int maxDepth = std::clamp(limits.maxDepth, 1, MAX_PLY - 1);
+    const int lines = std::clamp(limits.multiPv, 1, static_cast<int>(rootMoves.size()));
+    for (int depth = 1 + threadIndex_ % 2; depth <= maxDepth; ++depth) {
+        // Each further line is a full-window search with the better root moves taken out.
+        excludedRoot_.clear();
+        int score = 0;
+        for (int line = 1; line <= lines; ++line) {
+            const int lineScore = negamax(-INF, INF, depth, 0);
+            if (stopped_) break;
+
+            std::vector<PackedMove> pv(pvTable_[0].begin(), pvTable_[0].begin() + pvLength_[0]);
+            if (line == 1) {
+                score = lineScore;
+                previousPv_ = pv;
+                if (!pv.empty()) best = pv.front();
+            }
+
+            if (onInfo) {
+                Info info;
+                info.depth = depth;
+                info.score = lineScore;
+                info.nodes = nodes();
+                info.timeMs = elapsedMs();
+                info.hashfull = tt_.hashfull();
+                info.multiPv = line;
+                info.pv = pv;
+                onInfo(info);
+            }
+            if (pv.empty()) break;
+            excludedRoot_.push_back(pv.front());
+        }
+        excludedRoot_.clear();
+        if (stopped_) break;
+
+        if (isMateScore(score) && MATE - std::abs(score) <= depth) break;
+        if (managed) {
+            // A forced reply needs no thinking on the clock.
+            if (rootMoves.size() == 1 || timeManager_.iterationDone(best, score, elapsedMs())) break;
+        } else if (limits_.movetimeMs > 0 && elapsedMs() * 2 > limits_.movetimeMs) {
+            // The next iteration usually costs several times the last one; don't start what can't finish.
+            break;
+        }
+    }
+    return best;
+}
+
+void Search::stop() noexcept {
+    stopped_ = true;
+}
+
+std::uint64_t Search::nodes() const noexcept {
+    return nodes_.load(std::memory_order_relaxed);
+}
+
+bool Search::isMateScore(int score) noexcept {
+    return std::abs(score) >= MATE_BOUND;
+}
+
+int Search::mateInMoves(int score) noexcept {
+    return score > 0 ? (MATE - score + 1) / 2 : -(MATE + score) / 2;
+}
+
+int Search::depthForElo(int elo) noexcept {
+    // 1200 searches 2 plies, 2000 searches 6.
+    return std::clamp((elo - 800) / 200, 1, MAX_PLY - 1);
+}
+
+int Search::negamax(int alpha, int beta, int depth, int ply) {
+    pvLength_[ply] = ply;
+    if (ply > 0 && (state_.halfmoveClock() >= 100 || state_.isRepetition())) return 0;
+
+    const bool inCheck = MoveGenerator::isInCheck(state_.board(), state_.sideToMove());
+    if (inCheck) ++depth;
+    if (depth <= 0) return quiescence(alpha, beta, ply);
+
+    countNode();
+    if (stopped_) return 0;
+    if (ply >= MAX_PLY - 1) return Evaluation::evaluate(state_, pawnCache_);
+
+    const std::uint64_t key = state_.key();
+    TranspositionTable::Entry entry;
+    PackedMove ttMove;
+    if (tt_.probe(key, entry)) {
+        ttMove = entry.move();
+        if (ply > 0 && entry.depth() >= depth) {
+            const int score = scoreFromTable(entry.score(), ply);
+            const auto bound = entry.bound();
+            if (bound == TranspositionTable::Bound::Exact
+                || (bound == TranspositionTable::Bound::Lower && score >= beta)
+                || (bound == TranspositionTable::Bound::Upper && score <= alpha))
+                return score;
+        }
+    }
+
+    const PackedMove previous = ply > 0 ? moveStack_[ply - 1] : PackedMove{};
+    MovePicker picker(state_, ttMove, &heuristics_, ply, previous);
+    MoveList quietsTried;
+
+    const int originalAlpha = alpha;
+    int bestScore = -INF;
+    PackedMove bestMove;
+    GameState::UndoInfo undo;
+    int legalMoves = 0;
+    while (const PackedMove move = picker.next()) {
+        if (ply == 0 && std::ranges::find(excludedRoot_, move) != excludedRoot_.end()) continue;
+        ++legalMoves;
+        const bool quiet = isQuiet(state_.board(), move);
+        moveStack_[ply] = move;
+        state_.makeMove(move, undo);
+        const int score = -negamax(-beta, -alpha, depth - 1, ply + 1);
+        state_.unmakeMove(move, undo);
+        if (stopped_) return 0;
+
+        if (score > bestScore) {
+            bestScore = score;
+            bestMove = move;
+        }
+        if (score > alpha) {
+            alpha = score;
+            updatePv(ply, move);
+            if (alpha >= beta) {
+                if (quiet) {
+                    heuristics_.onQuietCutoff(state_.sideToMove(), ply, move, previous, depth,
+                                              quietsTried.begin(), quietsTried.size());
+                }
+                break;
+            }
+        }
+        if (quiet) quietsTried.push_back(move);
+    }
+    if (legalMoves == 0) return inCheck ? -MATE + ply : 0;
+
+    const auto bound = bestScore >= beta
+                           ? TranspositionTable::Bound::Lower
+                           : bestScore > originalAlpha
+                                 ? TranspositionTable::Bound::Exact
+                                 : TranspositionTable::Bound::Upper;
+    // A root searched without its best moves must not overwrite the real root entry.
+    if (ply > 0 || excludedRoot_.empty())
+        tt_.store(key, depth, bound, bestMove, scoreToTable(bestScore, ply));
+    return bestScore;
+}
+
+int Search::quiescence(int alpha, int beta, int ply) {
+    pvLength_[ply] = ply;
+    countNode();
+    if (stopped_) return 0;
+
+    const bool inCheck = MoveGenerator::isInCheck(state_.board(), state_.sideToMove());
+    if (ply >= MAX_PLY - 1) return inCheck ? 0 : Evaluation::evaluate(state_, pawnCache_);
+
+    int bestScore = -INF;
+    if (!inCheck) {
+        bestScore = Evaluation::evaluate(state_, pawnCache_);
+        if (bestScore >= beta) return bestScore;
+        if (bestScore > alpha) alpha = bestScore;
+    }
+
+    // Out of check every evasion is searched; otherwise only captures and queen promotions.
+    MovePicker picker = inCheck
+                            ? MovePicker(state_, PackedMove{}, nullptr, ply, PackedMove{})
+                            : MovePicker(state_, PackedMove{});
+    GameState::UndoInfo undo;
+    int legalMoves = 0;
+    while (const PackedMove move = picker.next()) {
+        ++legalMoves;
+        // A capture that loses material in the exchange cannot raise the stand-pat score.
+        if (!inCheck && !MoveGenerator::see(state_.board(), move, 0)) continue;
+        moveStack_[ply] = move;
+        state_.makeMove(move, undo);
+        const int score = -quiescence(-beta, -alpha, ply + 1);
+        state_.unmakeMove(move, undo);
+        if (stopped_) return 0;
+
+        if (score > bestScore) bestScore = score;
+        if (score > alpha) {
+            alpha = score;
+            updatePv(ply, move);
+            if (alpha >= beta) break;
+        }
+    }
+    if (inCheck && legalMoves == 0) return -MATE + ply;
+    return bestScore;
+}
+
+void Search::updatePv(int ply, PackedMove move) {
+    pvTable_[ply][ply] = move;
+    for (int i = ply + 1; i < pvLength_[ply + 1]; ++i)
+        pvTable_[ply][i] = pvTable_[ply + 1][i];
+    pvLength_[ply] = std::max(pvLength_[ply + 1], ply + 1);
+}
+
+void Search::countNode() {
+    // Only this thread writes the counter; other threads merely sum it for reporting.
+    const std::uint64_t nodes = nodes_.load(std::memory_order_relaxed) + 1;
+    nodes_.store(nodes, std::memory_order_relaxed);
+    if (limits_.maxNodes > 0 && nodes >= limits_.maxNodes) stopped_ = true;
+    if (sharedStop_ && sharedStop_->load(std::memory_order_relaxed)) stopped_ = true;
+    if ((nodes & 1023) == 0 && limits_.movetimeMs > 0 && elapsedMs() >= limits_.movetimeMs)
+        stopped_ = true;
+}
+
+std::int64_t Search::elapsedMs() const {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start_).count();
+}
+
+// Mate scores are stored relative to the node so they stay valid when reached at another ply.
+int Search::scoreToTable(int score, int ply) noexcept {
+    if (score >= MATE_BOUND) return score + ply;
+    if (score <= -MATE_BOUND) return score - ply;
+    return score;
+}
+
+int Search::scoreFromTable(int score, int ply) noexcept {
+    if (score >= MATE_BOUND) return score - ply;
+    if (score <= -MATE_BOUND) return score + ply;
+    return score;
+}
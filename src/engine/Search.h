@@ -0,0 +1,95 @@
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include "../GameState.h"
+#include "../MoveList.h"
+#include "../MovePicker.h"
+#include "../PackedMove.h"
+#include "../TranspositionTable.h"
+#include "PawnStructure.h"
+#include "TimeManager.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+class Search {
+public:
+    static constexpr int MAX_PLY = 64;
+    static constexpr int INF = 32001;
+    static constexpr int MATE = 32000;
+    static constexpr int MATE_BOUND = MATE - MAX_PLY;
+    static_assert(MoveHeuristics::MAX_PLY >= MAX_PLY);
+
+    struct Limits {
+        int maxDepth = MAX_PLY - 1;
+        int movetimeMs = 0;
+        std::uint64_t maxNodes = 0;
+        // Number of best root moves to search with exact scores (UCI MultiPV).
+        int multiPv = 1;
+        // Used when movetimeMs is 0 and the clock has time on it; the TimeManager picks the budget.
+        TimeManager::Clock clock;
+    };
+
+    struct Info {
+        int depth = 0;
+        int score = 0;
+        std::uint64_t nodes = 0;
+        std::int64_t timeMs = 0;
+        int hashfull = 0;
+        // 1 for the best line, 2 for the runner-up, ...
+        int multiPv = 1;
+        std::vector<PackedMove> pv;
+    };
+
+    using InfoCallback = std::function<void(const Info&)>;
+
+    // A shared stop flag lets a thread pool halt several searches at once; helpers (threadIndex > 0)
+    // start one ply deeper so Lazy SMP threads diverge instead of repeating the main thread's work.
+    explicit Search(TranspositionTable& tt, const std::atomic<bool>* sharedStop = nullptr, int threadIndex = 0);
+
+    // Iterative deepening from the given position; returns a null move when there is no legal move.
+    // Aging the table between searches is left to the caller.
+    PackedMove think(const GameState& root, const Limits& limits, const InfoCallback& onInfo = {});
+
+    // Safe to call from another thread while think() is running.
+    void stop() noexcept;
+
+    [[nodiscard]] std::uint64_t nodes() const noexcept;
+
+    [[nodiscard]] static bool isMateScore(int score) noexcept;
+    [[nodiscard]] static int mateInMoves(int score) noexcept;
+    // Depth cap that approximates the given UCI_Elo: roughly two plies per 400 Elo.
+    [[nodiscard]] static int depthForElo(int elo) noexcept;
+
+private:
+    int negamax(int alpha, int beta, int depth, int ply);
+    int quiescence(int alpha, int beta, int ply);
+    void updatePv(int ply, PackedMove move);
+    void countNode();
+    [[nodiscard]] std::int64_t elapsedMs() const;
+    [[nodiscard]] static int scoreToTable(int score, int ply) noexcept;
+    [[nodiscard]] static int scoreFromTable(int score, int ply) noexcept;
+
+    TranspositionTable& tt_;
+    const std::atomic<bool>* sharedStop_;
+    int threadIndex_;
+    GameState state_;
+    Limits limits_;
+    std::atomic<bool> stopped_{false};
+    std::atomic<std::uint64_t> nodes_{0};
+    std::chrono::steady_clock::time_point start_;
+    std::array<std::array<PackedMove, MAX_PLY>, MAX_PLY> pvTable_{};
+    std::array<int, MAX_PLY> pvLength_{};
+    std::vector<PackedMove> previousPv_;
+    // Root moves already reported as better lines in this iteration.
+    std::vector<PackedMove> excludedRoot_;
+    std::array<PackedMove, MAX_PLY> moveStack_{};
+    MoveHeuristics heuristics_;
+    PawnCache pawnCache_;
+    TimeManager timeManager_;
+};
+
+#endif //SEARCH_H
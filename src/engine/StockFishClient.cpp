@@ -1,17 +1,31 @@
 #include "StockFishClient.h"
+#include <QCoreApplication>
 #include <QThread>
 #include <QtGlobal>
+#include <utility>
 
-StockfishClient::StockfishClient(QObject *parent)
-    : QObject(parent) {
-    connect(&m_proc, &QProcess::readyReadStandardOutput,
-            this, &StockfishClient::onReadyRead);
-    connect(&m_proc, &QProcess::errorOccurred,
-            this, &StockfishClient::onError);
-    connect(&m_proc, &QProcess::started,
-            this, &StockfishClient::onStarted);
+namespace {
+    // How long a process asked to quit may take before it is killed.
+    constexpr int QUIT_TIMEOUT_MS = 1000;
+
+    QString setOptionCommand(const QString &name, const QString &value) {
+        return QString::fromStdString(UciProtocol::setOption(name.toStdString(), value.toStdString()));
+    }
+
+    std::vector<std::string> toStdMoves(const QStringList &uciMoves) {
+        std::vector<std::string> moves;
+        moves.reserve(uciMoves.size());
+        for (const QString &move: uciMoves) moves.push_back(move.toStdString());
+        return moves;
+    }
 
-    m_proc.setProcessChannelMode(QProcess::MergedChannels);
+    QString clockArguments(int wtimeMs, int btimeMs, int wincMs, int bincMs, int movesToGo) {
+        return QString::fromStdString(UciProtocol::clockArguments(wtimeMs, btimeMs, wincMs, bincMs, movesToGo));
+    }
+}
+
+StockfishClient::StockfishClient(QObject *parent)
+    : ChessEngine(parent) {
 }
 
 StockfishClient::~StockfishClient() {
@@ -19,54 +33,89 @@ StockfishClient::~StockfishClient() {
 }
 
 void StockfishClient::start(const QString &enginePath) {
-    if (m_proc.state() != QProcess::NotRunning) {
-        quit();
-    }
-    m_uciOk = false;
-    m_readyOk = false;
+    quit();
+    m_pondering = false;
+    m_discardBestMoves = 0;
+    m_position.clear();
     m_options.clear();
+    m_lines.clear();
 
-    m_proc.start(enginePath);
-    if (!m_proc.waitForStarted(1000)) {
-        emit errorText(QString("Не удалось запустить движок: %1").arg(enginePath));
-        return;
-    }
-    requestUciHandshake();
+    m_proc = new QProcess(this);
+    m_proc->setProcessChannelMode(QProcess::MergedChannels);
+    connect(m_proc, &QProcess::readyReadStandardOutput,
+            this, &StockfishClient::onReadyRead);
+    connect(m_proc, &QProcess::errorOccurred,
+            this, &StockfishClient::onError);
+    connect(m_proc, &QProcess::started,
+            this, &StockfishClient::onStarted);
+
+    m_state = State::Starting;
+    m_readyPending = 0;
+    m_proc->start(enginePath);
 }
 
 void StockfishClient::quit() {
-    if (m_proc.state() != QProcess::NotRunning) {
-        m_quitting_ = true;
-        send("quit");
-        m_proc.waitForFinished(200);
-        if (m_proc.state() != QProcess::NotRunning) {
-            m_proc.kill();
-            m_proc.waitForFinished(200);
-        }
-        m_quitting_ = false;
+    m_state = State::Stopped;
+    m_readyPending = 0;
+    m_pending.clear();
+    m_pendingOptions.clear();
+    if (!m_proc) return;
+
+    // The old process finishes on its own; nothing it says from now on concerns this client.
+    // The application keeps it so that an exit within the grace period still reaps it.
+    QProcess *proc = m_proc;
+    m_proc = nullptr;
+    proc->disconnect(this);
+    proc->setParent(QCoreApplication::instance());
+    if (proc->state() == QProcess::NotRunning) {
+        proc->deleteLater();
+        return;
     }
+    connect(proc, &QProcess::finished, proc, &QObject::deleteLater);
+    QTimer::singleShot(QUIT_TIMEOUT_MS, proc, [proc] {
+        if (proc->state() != QProcess::NotRunning) proc->kill();
+    });
+    if (QCoreApplication::instance()) {
+        connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, proc, [proc] {
+            if (proc->state() == QProcess::NotRunning) return;
+            proc->kill();
+            proc->waitForFinished(QUIT_TIMEOUT_MS);
+        });
+    }
+    proc->write("quit\n");
+    proc->closeWriteChannel();
 }
 
 bool StockfishClient::isRunning() const {
-    return m_proc.state() != QProcess::NotRunning;
+    return m_proc && m_proc->state() != QProcess::NotRunning;
+}
+
+bool StockfishClient::awaitingReady() const {
+    return (m_state != State::Ready && m_state != State::Stopped) || m_readyPending > 0;
 }
 
 void StockfishClient::newGame() {
+    if (m_pondering) stop();
+    m_position.clear();
     send("ucinewgame");
     isReady();
 }
 
 void StockfishClient::isReady() {
-    m_readyOk = false;
+    if (m_state == State::Stopped) return;
+    ++m_readyPending;
     send("isready");
 }
 
 void StockfishClient::setOption(const QString &name, const QString &value) {
-    if (!m_uciOk) return;
+    if (m_state == State::Starting || m_state == State::WaitingUciOk) {
+        m_pendingOptions.append({name, value});
+        return;
+    }
     if (!m_options.isEmpty() && !m_options.contains(name)) {
         return;
     }
-    send(QString("setoption name %1 value %2").arg(name, value));
+    send(setOptionCommand(name, value));
 }
 
 void StockfishClient::setSkillLevel(int skill0to20) {
@@ -79,19 +128,11 @@ void StockfishClient::setDifficultyElo(int elo, bool limitStrength) {
 }
 
 void StockfishClient::setPositionFEN(const QString &fen, const QStringList &uciMoves) {
-    QString cmd = QString("position fen %1").arg(fen);
-    if (!uciMoves.isEmpty()) {
-        cmd += " moves " + uciMoves.join(' ');
-    }
-    send(cmd);
+    sendPosition(QString::fromStdString(UciProtocol::position(fen.toStdString(), toStdMoves(uciMoves))));
 }
 
 void StockfishClient::setPositionFromStartpos(const QStringList &uciMoves) {
-    QString cmd = "position startpos";
-    if (!uciMoves.isEmpty()) {
-        cmd += " moves " + uciMoves.join(' ');
-    }
-    send(cmd);
+    sendPosition(QString::fromStdString(UciProtocol::position({}, toStdMoves(uciMoves))));
 }
 
 void StockfishClient::goDepth(int depth) {
@@ -102,19 +143,57 @@ void StockfishClient::goMovetime(int ms) {
     send(QString("go movetime %1").arg(ms));
 }
 
-void StockfishClient::goClock(int wtimeMs, int btimeMs, int wincMs, int bincMs) {
-    send(QString("go wtime %1 btime %2 winc %3 binc %4")
-        .arg(wtimeMs).arg(btimeMs).arg(wincMs).arg(bincMs));
+void StockfishClient::goInfinite() {
+    send("go infinite");
+}
+
+void StockfishClient::goClock(int wtimeMs, int btimeMs, int wincMs, int bincMs, int movesToGo) {
+    send("go " + clockArguments(wtimeMs, btimeMs, wincMs, bincMs, movesToGo));
+}
+
+void StockfishClient::goPonder(int wtimeMs, int btimeMs, int wincMs, int bincMs, int movesToGo) {
+    m_pondering = true;
+    send("go ponder " + clockArguments(wtimeMs, btimeMs, wincMs, bincMs, movesToGo));
+}
+
+void StockfishClient::ponderHit() {
+    if (!m_pondering) return;
+    m_pondering = false;
+    send("ponderhit");
+}
+
+void StockfishClient::stop() {
+    if (m_pondering) {
+        m_pondering = false;
+        ++m_discardBestMoves;
+    }
+    send("stop");
 }
 
 void StockfishClient::send(const QString &line) {
-    if (m_proc.state() == QProcess::NotRunning) return;
-    QByteArray bytes = (line + "\n").toUtf8();
-    m_proc.write(bytes);
+    if (m_state == State::Stopped) return;
+    if (m_state != State::Ready) {
+        m_pending << line;
+        return;
+    }
+    write(line);
+}
+
+void StockfishClient::write(const QString &line) {
+    if (!m_proc || m_proc->state() == QProcess::NotRunning) return;
+    m_proc->write((line + "\n").toUtf8());
+}
+
+// UCI has no incremental form of "position", but a position the engine already holds is not resent.
+void StockfishClient::sendPosition(const QString &command) {
+    if (command == m_position) return;
+    m_position = command;
+    send(command);
 }
 
 void StockfishClient::requestUciHandshake() {
-    send("uci");
+    m_state = State::WaitingUciOk;
+    write("uci");
 }
 
 void StockfishClient::onStarted() {
@@ -122,9 +201,22 @@ void StockfishClient::onStarted() {
 }
 
 void StockfishClient::onReadyRead() {
-    while (m_proc.canReadLine()) {
-        const QByteArray raw = m_proc.readLine();
-        const QString s = QString::fromUtf8(raw).trimmed();
+    if (!m_proc) return;
+    const QByteArray chunk = m_proc->readAll();
+    m_lines.append(std::string_view(chunk.constData(), chunk.size()));
+    // A handler below may quit() the client; the rest of its output then concerns nobody.
+    while (m_proc) {
+        const auto line = m_lines.next();
+        if (!line) break;
+        if (line->starts_with("info ")) {
+            // The bulk of the output: decoded in place, and mostly dropped by the coalescer.
+            if (auto parsed = UciInfo::parse(*line))
+                infoCoalescer_.push(std::move(*parsed));
+            else if (line->starts_with("info string "))
+                emit info(QString::fromUtf8(line->data(), line->size()).trimmed());
+            continue;
+        }
+        const QString s = QString::fromUtf8(line->data(), line->size()).trimmed();
 
         if (s.isEmpty()) continue;
 
@@ -138,46 +230,56 @@ void StockfishClient::onReadyRead() {
             emit engineBanner(QString(), author);
             continue;
         }
-        if (s.startsWith("option name ")) {
-            const QString name = s.mid(QString("option name ").size()).section(' ', 0, 0);
-            m_options.insert(name);
+        if (const auto name = UciProtocol::parseOptionName(*line)) {
+            m_options.insert(QString::fromStdString(*name));
             continue;
         }
         if (s == "uciok") {
-            m_uciOk = true;
+            if (m_state != State::WaitingUciOk) continue;
+            m_state = State::WaitingReadyOk;
             if (m_options.contains("Threads"))
-                setOption(
-                    "Threads", QString::number(qMax(1, QThread::idealThreadCount())));
-            if (m_options.contains("Hash")) setOption("Hash", "128");
-            isReady();
+                write(setOptionCommand("Threads", QString::number(qMax(1, QThread::idealThreadCount()))));
+            if (m_options.contains("Hash")) write(setOptionCommand("Hash", "128"));
+            if (m_options.contains("Ponder")) write(setOptionCommand("Ponder", "true"));
+            const auto options = std::exchange(m_pendingOptions, {});
+            for (const auto &[name, value]: options) {
+                if (m_options.contains(name)) write(setOptionCommand(name, value));
+            }
+            write("isready");
             continue;
         }
         if (s == "readyok") {
-            m_readyOk = true;
+            if (m_state == State::WaitingReadyOk) {
+                // The handshake's own isready; queued ones are only written now.
+                m_state = State::Ready;
+                const QStringList pending = std::exchange(m_pending, {});
+                for (const QString &line: pending) write(line);
+            } else if (m_readyPending > 0) {
+                --m_readyPending;
+            }
             emit engineReady();
             continue;
         }
-        if (s.startsWith("bestmove ")) {
-            const QString rest = s.mid(QString("bestmove ").size());
-            const QString best = rest.section(' ', 0, 0);
-            QString ponder;
-            if (rest.contains(" ponder ")) {
-                ponder = rest.section(" ponder ", 1, 1).trimmed();
+        if (const auto best = UciProtocol::parseBestMove(*line)) {
+            infoCoalescer_.flush();
+            if (m_discardBestMoves > 0) {
+                --m_discardBestMoves;
+                continue;
             }
-            emit bestMove(best, ponder);
-            continue;
-        }
-        if (s.startsWith("info ")) {
-            emit info(s);
+            emit bestMove(QString::fromStdString(best->move), QString::fromStdString(best->ponder));
             continue;
         }
-
         emit info(s);
     }
 }
 
 void StockfishClient::onError(QProcess::ProcessError e) {
-    if (m_quitting_) return;
+    if (e == QProcess::FailedToStart || e == QProcess::Crashed) {
+        m_state = State::Stopped;
+        m_readyPending = 0;
+        m_pending.clear();
+        m_pendingOptions.clear();
+    }
     QString msg = "Неизвестная ошибка процесса.";
     switch (e) {
         case QProcess::FailedToStart: msg = "Движок не стартовал (неправильный путь или нет прав).";
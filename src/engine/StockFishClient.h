@@ -1,43 +1,48 @@
 #ifndef STOCKFISHCLIENT_H
 #define STOCKFISHCLIENT_H
 
-#include <QObject>
+#include "ChessEngine.h"
+#include "UciProtocol.h"
 #include <QProcess>
 #include <QStringList>
 #include <QRegularExpression>
 #include <QTimer>
 #include <QSet>
+#include <QPair>
+#include <QList>
 
-class StockfishClient : public QObject {
+// Talks UCI to an external engine process. Nothing here blocks the GUI thread: start() only launches
+// the process and the uci/uciok/isready/readyok handshake runs from its output. Commands issued
+// before the first readyok are queued and sent in order once the engine is ready; quit() hands
+// the process off to shut down (or be killed) in the background.
+class StockfishClient : public ChessEngine {
     Q_OBJECT
 public:
     explicit StockfishClient(QObject* parent = nullptr);
     ~StockfishClient() override;
 
-    void start(const QString& enginePath);
-    void quit();
-    bool isRunning() const;
+    void start(const QString& enginePath) override;
+    void quit() override;
+    bool isRunning() const override;
+    bool awaitingReady() const override;
 
-    void newGame();
+    void newGame() override;
     void isReady();
 
-    void setOption(const QString& name, const QString& value);
+    void setOption(const QString& name, const QString& value) override;
     void setSkillLevel(int skill0to20);
-    void setDifficultyElo(int elo, bool limitStrength = true);
+    void setDifficultyElo(int elo, bool limitStrength = true) override;
 
-    void setPositionFEN(const QString& fen, const QStringList& uciMoves = {});
-    void setPositionFromStartpos(const QStringList& uciMoves);
+    void setPositionFEN(const QString& fen, const QStringList& uciMoves = {}) override;
+    void setPositionFromStartpos(const QStringList& uciMoves) override;
 
-    void goDepth(int depth);
-    void goMovetime(int ms);
-    void goClock(int wtimeMs, int btimeMs, int wincMs = 0, int bincMs = 0);
-
-signals:
-    void engineReady();
-    void bestMove(const QString& uciMove, const QString& ponder);
-    void info(const QString& line);
-    void errorText(const QString& message);
-    void engineBanner(const QString& name, const QString& author);
+    void goDepth(int depth) override;
+    void goMovetime(int ms) override;
+    void goInfinite() override;
+    void goClock(int wtimeMs, int btimeMs, int wincMs = 0, int bincMs = 0, int movesToGo = 0) override;
+    void goPonder(int wtimeMs, int btimeMs, int wincMs = 0, int bincMs = 0, int movesToGo = 0) override;
+    void ponderHit() override;
+    void stop() override;
 
 private slots:
     void onReadyRead();
@@ -45,13 +50,27 @@ private slots:
     void onStarted();
 
 private:
+    enum class State { Stopped, Starting, WaitingUciOk, WaitingReadyOk, Ready };
+
     void send(const QString& line);
+    // Bypasses the queue; used by the handshake itself.
+    void write(const QString& line);
     void requestUciHandshake();
+    void sendPosition(const QString& command);
 
-    QProcess m_proc;
-    bool m_uciOk = false;
-    bool m_readyOk = false;
-    bool m_quitting_ = false;
+    QProcess* m_proc = nullptr;
+    UciProtocol::LineBuffer m_lines;
+    State m_state = State::Stopped;
+    // isready commands sent after the handshake and not yet answered.
+    int m_readyPending = 0;
+    QStringList m_pending;
+    // Options can only be checked against the engine's list after uciok.
+    QList<QPair<QString, QString>> m_pendingOptions;
+    bool m_pondering = false;
+    // The last position command, i.e. what the engine currently has set up.
+    QString m_position;
+    // Replies to searches that were cancelled while pondering; the GUI never asked for them.
+    int m_discardBestMoves = 0;
     QSet<QString> m_options;
 };
 #endif // STOCKFISHCLIENT_H
\ No newline at end of file
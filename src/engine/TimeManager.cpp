@@ -0,0 +1,61 @@
+#include "TimeManager.h"
+#include <algorithm>
+
+namespace {
+    // Moves the remaining time is spread over when the control gives no movestogo.
+    constexpr int HORIZON = 35;
+    constexpr int STABLE_ITERATIONS = 4;
+}
+
+void TimeManager::init(const Clock &clock) {
+    const std::int64_t usable = std::max<std::int64_t>(1, clock.remainingMs - clock.overheadMs);
+    const int movesToGo = clock.movesToGo > 0 ? std::min(clock.movesToGo, 50) : HORIZON;
+
+    // With the control about to reset nearly everything may go into this move; otherwise keep
+    // enough in reserve that one long think cannot lose the game on time.
+    const std::int64_t cap = movesToGo == 1 ? usable * 9 / 10 : usable / 3;
+    optimum_ = usable / movesToGo + clock.incrementMs * 3 / 4;
+    maximum_ = std::max<std::int64_t>(1, std::min(optimum_ * 4, cap));
+    optimum_ = std::clamp<std::int64_t>(optimum_, 1, maximum_);
+    target_ = optimum_;
+
+    lastBest_ = PackedMove();
+    lastScore_ = 0;
+    iterations_ = 0;
+    stableIterations_ = 0;
+    instability_ = 0.0;
+}
+
+std::int64_t TimeManager::optimumMs() const noexcept {
+    return optimum_;
+}
+
+std::int64_t TimeManager::maximumMs() const noexcept {
+    return maximum_;
+}
+
+std::int64_t TimeManager::targetMs() const noexcept {
+    return target_;
+}
+
+bool TimeManager::iterationDone(PackedMove best, int score, std::int64_t elapsedMs) {
+    double scale = 1.0;
+    if (iterations_ > 0) {
+        const bool changed = best != lastBest_;
+        instability_ = instability_ * 0.5 + (changed ? 1.0 : 0.0);
+        stableIterations_ = changed ? 0 : stableIterations_ + 1;
+        scale += instability_;
+
+        // A falling score means the position is harder than it looked: think longer.
+        const int drop = std::clamp(lastScore_ - score, 0, 150);
+        scale *= 1.0 + drop / 300.0;
+    }
+    if (stableIterations_ >= STABLE_ITERATIONS) scale *= 0.6;
+
+    ++iterations_;
+    lastBest_ = best;
+    lastScore_ = score;
+    target_ = std::clamp<std::int64_t>(static_cast<std::int64_t>(optimum_ * scale), 1, maximum_);
+    // The next iteration usually costs several times the last one; don't start what can't finish.
+    return elapsedMs * 2 > target_;
+}
@@ -0,0 +1,44 @@
+#ifndef TIMEMANAGER_H
+#define TIMEMANAGER_H
+
+#include "../PackedMove.h"
+#include <cstdint>
+
+// Splits the side-to-move's clock into a per-move budget. The optimum is what an ordinary move
+// may use; after each iteration the budget grows when the best move keeps changing or the score
+// falls, and shrinks when the same move has survived several iterations. Maximum is the hard cap.
+class TimeManager {
+public:
+    struct Clock {
+        std::int64_t remainingMs = 0;
+        std::int64_t incrementMs = 0;
+        // 0 means the rest of the game must be played on the remaining time.
+        int movesToGo = 0;
+        // Reserved per move for GUI and process latency.
+        std::int64_t overheadMs = 30;
+    };
+
+    void init(const Clock& clock);
+
+    [[nodiscard]] std::int64_t optimumMs() const noexcept;
+    [[nodiscard]] std::int64_t maximumMs() const noexcept;
+
+    // Feed the result of a finished iteration; returns true when starting another one is not worth it.
+    bool iterationDone(PackedMove best, int score, std::int64_t elapsedMs);
+
+    // The budget optimumMs() is currently scaled to.
+    [[nodiscard]] std::int64_t targetMs() const noexcept;
+
+private:
+    std::int64_t optimum_ = 0;
+    std::int64_t maximum_ = 0;
+    std::int64_t target_ = 0;
+    PackedMove lastBest_;
+    int lastScore_ = 0;
+    int iterations_ = 0;
+    int stableIterations_ = 0;
+    // Best-move changes, halved every iteration so that old ones count less.
+    double instability_ = 0.0;
+};
+
+#endif //TIMEMANAGER_H
@@ -0,0 +1,93 @@
+#include "UciInfo.h"
+#include <charconv>
+
+namespace {
+    class Tokens {
+    public:
+        explicit Tokens(std::string_view text) : text_(text) {}
+
+        std::string_view next() {
+            while (pos_ < text_.size() && isSpace(text_[pos_])) ++pos_;
+            const std::size_t begin = pos_;
+            while (pos_ < text_.size() && !isSpace(text_[pos_])) ++pos_;
+            return text_.substr(begin, pos_ - begin);
+        }
+
+        template<typename T>
+        bool number(T &out) {
+            const std::string_view token = next();
+            const auto result = std::from_chars(token.data(), token.data() + token.size(), out);
+            return result.ec == std::errc() && result.ptr == token.data() + token.size();
+        }
+
+    private:
+        static bool isSpace(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; }
+
+        std::string_view text_;
+        std::size_t pos_ = 0;
+    };
+
+    std::optional<PackedMove> decodeMove(std::string_view uci) {
+        if (uci.size() != 4 && uci.size() != 5) return std::nullopt;
+        for (int i: {0, 2}) {
+            if (uci[i] < 'a' || uci[i] > 'h' || uci[i + 1] < '1' || uci[i + 1] > '8') return std::nullopt;
+        }
+        const int from = (uci[1] - '1') * 8 + (uci[0] - 'a');
+        const int to = (uci[3] - '1') * 8 + (uci[2] - 'a');
+        if (uci.size() == 4) return PackedMove(from, to);
+        PieceType promo;
+        switch (uci[4]) {
+            case 'q': promo = PieceType::Queen;
+                break;
+            case 'r': promo = PieceType::Rook;
+                break;
+            case 'b': promo = PieceType::Bishop;
+                break;
+            case 'n': promo = PieceType::Knight;
+                break;
+            default: return std::nullopt;
+        }
+        return PackedMove(from, to, PackedMove::Promotion, promo);
+    }
+}
+
+std::optional<UciInfo> UciInfo::parse(std::string_view line) {
+    Tokens tokens(line);
+    if (tokens.next() != "info") return std::nullopt;
+
+    UciInfo info;
+    for (std::string_view key = tokens.next(); !key.empty(); key = tokens.next()) {
+        bool ok = true;
+        if (key == "depth") ok = tokens.number(info.depth);
+        else if (key == "seldepth") ok = tokens.number(info.selDepth);
+        else if (key == "multipv") ok = tokens.number(info.multiPv);
+        else if (key == "nodes") ok = tokens.number(info.nodes);
+        else if (key == "nps") ok = tokens.number(info.nps);
+        else if (key == "tbhits") ok = tokens.number(info.tbHits);
+        else if (key == "hashfull") ok = tokens.number(info.hashfull);
+        else if (key == "time") ok = tokens.number(info.timeMs);
+        else if (key == "score") {
+            const std::string_view kind = tokens.next();
+            if (kind != "cp" && kind != "mate") return std::nullopt;
+            info.isMate = kind == "mate";
+            ok = tokens.number(info.score);
+            info.hasScore = ok;
+        } else if (key == "lowerbound") info.bound = Bound::Lower;
+        else if (key == "upperbound") info.bound = Bound::Upper;
+        else if (key == "pv") {
+            // The principal variation runs to the end of the line.
+            for (std::string_view move = tokens.next(); !move.empty(); move = tokens.next()) {
+                const auto packed = decodeMove(move);
+                if (!packed) break;
+                info.pv.push_back(*packed);
+            }
+        } else if (key == "string") {
+            return std::nullopt;
+        }
+        // Anything else (currmove, wdl, refutation, ...) is not needed by the GUI and is skipped
+        // token by token; its arguments never collide with the keys above.
+        if (!ok) return std::nullopt;
+    }
+    if (!info.hasScore && info.pv.empty()) return std::nullopt;
+    return info;
+}
@@ -0,0 +1,37 @@
+#ifndef UCIINFO_H
+#define UCIINFO_H
+
+#include "../PackedMove.h"
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+// One decoded "info" line of a UCI engine. Fields the engine did not send keep their defaults.
+struct UciInfo {
+    enum class Bound : std::uint8_t { Exact, Lower, Upper };
+
+    int depth = 0;
+    int selDepth = 0;
+    int multiPv = 1;
+    bool hasScore = false;
+    // Centipawns, or with isMate set the number of moves to mate (negative when getting mated).
+    int score = 0;
+    bool isMate = false;
+    Bound bound = Bound::Exact;
+    std::uint64_t nodes = 0;
+    std::uint64_t nps = 0;
+    std::uint64_t tbHits = 0;
+    int hashfull = 0;
+    std::int64_t timeMs = 0;
+    // Squares and promotion piece only: castling and en passant cannot be told apart from plain moves
+    // without the position, so those flags are never set. Resolve each move against the position
+    // (Move::fromUCIInPosition) before playing it.
+    std::vector<PackedMove> pv;
+
+    // Parses the raw line without building intermediate strings. Returns nothing for lines that
+    // are not "info", for "info string" and for progress lines that carry neither score nor pv.
+    static std::optional<UciInfo> parse(std::string_view line);
+};
+
+#endif //UCIINFO_H
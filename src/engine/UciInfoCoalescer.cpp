@@ -0,0 +1,41 @@
+#include "UciInfoCoalescer.h"
+#include <utility>
+
+UciInfoCoalescer::UciInfoCoalescer(int intervalMs, QObject *parent)
+    : QObject(parent) {
+    timer_.setInterval(intervalMs);
+    connect(&timer_, &QTimer::timeout, this, &UciInfoCoalescer::onTimeout);
+}
+
+void UciInfoCoalescer::setInterval(int ms) {
+    timer_.setInterval(qMax(0, ms));
+}
+
+int UciInfoCoalescer::interval() const {
+    return timer_.interval();
+}
+
+void UciInfoCoalescer::push(UciInfo info) {
+    if (!timer_.isActive()) {
+        // Quiet until now: show it at once and hold back whatever follows within the interval.
+        timer_.start();
+        emit ready(info);
+        return;
+    }
+    pending_.insert(info.multiPv, std::move(info));
+}
+
+void UciInfoCoalescer::flush() {
+    timer_.stop();
+    const auto pending = std::exchange(pending_, {});
+    for (const UciInfo &info: pending) emit ready(info);
+}
+
+void UciInfoCoalescer::onTimeout() {
+    if (pending_.isEmpty()) {
+        timer_.stop();
+        return;
+    }
+    const auto pending = std::exchange(pending_, {});
+    for (const UciInfo &info: pending) emit ready(info);
+}
@@ -0,0 +1,33 @@
+#ifndef UCIINFOCOALESCER_H
+#define UCIINFOCOALESCER_H
+
+#include "UciInfo.h"
+#include <QMap>
+#include <QObject>
+#include <QTimer>
+
+// Passes search updates on at most once per interval: the first one immediately, later ones only
+// as the newest per multipv line when the interval has elapsed. Intermediate lines are dropped.
+class UciInfoCoalescer : public QObject {
+    Q_OBJECT
+public:
+    explicit UciInfoCoalescer(int intervalMs = 100, QObject* parent = nullptr);
+
+    void setInterval(int ms);
+    [[nodiscard]] int interval() const;
+
+    void push(UciInfo info);
+    // Emits everything pending now, e.g. right before bestmove so the final line is not lost.
+    void flush();
+
+signals:
+    void ready(const UciInfo& info);
+
+private:
+    void onTimeout();
+
+    QTimer timer_;
+    QMap<int, UciInfo> pending_;
+};
+
+#endif // UCIINFOCOALESCER_H
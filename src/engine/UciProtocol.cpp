@@ -0,0 +1,92 @@
+#include "UciProtocol.h"
+
+namespace {
+    bool isSpace(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; }
+
+    std::string_view trimmed(std::string_view text) {
+        while (!text.empty() && isSpace(text.front())) text.remove_prefix(1);
+        while (!text.empty() && isSpace(text.back())) text.remove_suffix(1);
+        return text;
+    }
+
+    // Splits off the first whitespace-separated word of text.
+    std::string_view takeWord(std::string_view &text) {
+        text = trimmed(text);
+        std::size_t end = 0;
+        while (end < text.size() && !isSpace(text[end])) ++end;
+        const std::string_view word = text.substr(0, end);
+        text.remove_prefix(end);
+        return word;
+    }
+}
+
+void UciProtocol::LineBuffer::append(std::string_view data) {
+    buffer_.erase(0, offset_);
+    offset_ = 0;
+    buffer_.append(data);
+}
+
+std::optional<std::string_view> UciProtocol::LineBuffer::next() {
+    const auto newline = buffer_.find('\n', offset_);
+    if (newline == std::string::npos) return std::nullopt;
+    std::string_view line(buffer_.data() + offset_, newline - offset_);
+    offset_ = newline + 1;
+    if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+    return line;
+}
+
+void UciProtocol::LineBuffer::clear() noexcept {
+    buffer_.clear();
+    offset_ = 0;
+}
+
+bool UciProtocol::BestMove::hasMove() const noexcept {
+    return !move.empty() && move != "(none)" && move != "0000";
+}
+
+std::optional<UciProtocol::BestMove> UciProtocol::parseBestMove(std::string_view line) {
+    if (takeWord(line) != "bestmove") return std::nullopt;
+    BestMove best;
+    best.move = takeWord(line);
+    if (takeWord(line) == "ponder") best.ponder = takeWord(line);
+    return best;
+}
+
+std::optional<std::string> UciProtocol::parseOptionName(std::string_view line) {
+    if (takeWord(line) != "option" || takeWord(line) != "name") return std::nullopt;
+    line = trimmed(line);
+    const auto type = line.find(" type ");
+    return std::string(trimmed(line.substr(0, type)));
+}
+
+std::string UciProtocol::setOption(std::string_view name, std::string_view value) {
+    std::string command = "setoption name ";
+    command += name;
+    command += " value ";
+    command += value;
+    return command;
+}
+
+std::string UciProtocol::position(std::string_view fen, const std::vector<std::string> &moves) {
+    std::string command = "position ";
+    if (fen.empty()) {
+        command += "startpos";
+    } else {
+        command += "fen ";
+        command += fen;
+    }
+    if (!moves.empty()) command += " moves";
+    for (const std::string &move: moves) {
+        command += ' ';
+        command += move;
+    }
+    return command;
+}
+
+std::string UciProtocol::clockArguments(long long wtimeMs, long long btimeMs, long long wincMs, long long bincMs,
+                                        int movesToGo) {
+    std::string arguments = "wtime " + std::to_string(wtimeMs) + " btime " + std::to_string(btimeMs)
+                            + " winc " + std::to_string(wincMs) + " binc " + std::to_string(bincMs);
+    if (movesToGo > 0) arguments += " movestogo " + std::to_string(movesToGo);
+    return arguments;
+}
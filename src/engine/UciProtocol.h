@@ -0,0 +1,48 @@
+#ifndef UCIPROTOCOL_H
+#define UCIPROTOCOL_H
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Text side of UCI shared by StockfishClient and the headless match runner: splitting engine output
+// into lines, reading the replies a GUI acts on and building the commands it sends. Process handling
+// stays with the callers.
+class UciProtocol {
+public:
+    // Engine output arrives in arbitrary chunks; complete lines come out without their terminator.
+    // A line returned by next() points into the buffer and stays valid until the next append,
+    // next or clear. Consumed lines are dropped once per append, not once per line.
+    class LineBuffer {
+    public:
+        void append(std::string_view data);
+        std::optional<std::string_view> next();
+        void clear() noexcept;
+
+    private:
+        std::string buffer_;
+        std::size_t offset_ = 0;
+    };
+
+    struct BestMove {
+        // As sent; "(none)" or "0000" when the engine had no legal move.
+        std::string move;
+        std::string ponder;
+
+        [[nodiscard]] bool hasMove() const noexcept;
+    };
+
+    static std::optional<BestMove> parseBestMove(std::string_view line);
+    // Names may contain spaces ("Skill Level"); they end where " type " begins.
+    static std::optional<std::string> parseOptionName(std::string_view line);
+
+    static std::string setOption(std::string_view name, std::string_view value);
+    // An empty FEN means the initial position.
+    static std::string position(std::string_view fen, const std::vector<std::string>& moves);
+    // Arguments for "go" and "go ponder"; movesToGo 0 means sudden death.
+    static std::string clockArguments(long long wtimeMs, long long btimeMs, long long wincMs, long long bincMs,
+                                      int movesToGo = 0);
+};
+
+#endif //UCIPROTOCOL_H
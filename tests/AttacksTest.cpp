@@ -0,0 +1,25 @@
+#include <gtest/gtest.h>
+#include "../src/Attacks.h"
+
+TEST(AttacksTest, LeaperMasks) {
+    EXPECT_EQ(bb::popCount(Attacks::knight(bb::square(0, 0))), 2);
+    EXPECT_EQ(bb::popCount(Attacks::knight(bb::square(3, 3))), 8);
+    EXPECT_EQ(bb::popCount(Attacks::king(bb::square(0, 7))), 3);
+    EXPECT_EQ(Attacks::pawn(Color::White, bb::square(1, 0)), bb::squareBB(bb::square(2, 1)));
+    EXPECT_EQ(Attacks::pawn(Color::Black, bb::square(6, 7)), bb::squareBB(bb::square(5, 6)));
+}
+
+TEST(AttacksTest, SlidersStopAtBlockers) {
+    const int d4 = bb::square(3, 3);
+    EXPECT_EQ(bb::popCount(Attacks::rook(d4, 0)), 14);
+    EXPECT_EQ(bb::popCount(Attacks::bishop(d4, 0)), 13);
+
+    // блокеры на d6 и f4: d7, d8, g4, h4 недоступны
+    const Bitboard blockers = bb::squareBB(bb::square(5, 3)) | bb::squareBB(bb::square(3, 5));
+    const Bitboard rook = Attacks::rook(d4, blockers);
+    EXPECT_TRUE(rook & bb::squareBB(bb::square(5, 3)));
+    EXPECT_FALSE(rook & bb::squareBB(bb::square(6, 3)));
+    EXPECT_TRUE(rook & bb::squareBB(bb::square(3, 5)));
+    EXPECT_FALSE(rook & bb::squareBB(bb::square(3, 6)));
+    EXPECT_EQ(Attacks::queen(d4, blockers), rook | Attacks::bishop(d4, blockers));
+}
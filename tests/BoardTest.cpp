@@ -0,0 +1,51 @@
+#include <gtest/gtest.h>
+#include "../src/Board.h"
+
+TEST(BoardTest, InitialBitboards) {
+    Board board;
+    EXPECT_EQ(bb::popCount(board.occupied()), 32);
+    EXPECT_EQ(board.pieces(Color::White), 0x000000000000FFFFULL);
+    EXPECT_EQ(board.pieces(Color::Black), 0xFFFF000000000000ULL);
+    EXPECT_EQ(board.pieces(PieceType::Pawn), 0x00FF00000000FF00ULL);
+    EXPECT_EQ(board.kingSquare(Color::White), bb::square(0, 4));
+    EXPECT_EQ(board.kingSquare(Color::Black), bb::square(7, 4));
+
+    auto queen = board.pieceAt(0, 3);
+    ASSERT_TRUE(queen.has_value());
+    EXPECT_EQ(queen->type(), PieceType::Queen);
+    EXPECT_EQ(queen->color(), Color::White);
+    EXPECT_FALSE(board.pieceAt(3, 3).has_value());
+}
+
+TEST(BoardTest, CaptureKeepsSetsConsistent) {
+    Board board;
+    board.applyMove(Move(1, 4, 3, 4)); // e4
+    board.applyMove(Move(6, 3, 4, 3)); // d5
+    board.applyMove(Move(3, 4, 4, 3)); // exd5
+
+    EXPECT_EQ(bb::popCount(board.occupied()), 31);
+    EXPECT_EQ(bb::popCount(board.pieces(Color::Black, PieceType::Pawn)), 7);
+    EXPECT_EQ(board.pieces(Color::White) & board.pieces(Color::Black), 0ULL);
+    auto p = board.pieceAt(4, 3);
+    ASSERT_TRUE(p.has_value());
+    EXPECT_EQ(p->color(), Color::White);
+}
+
+TEST(BoardTest, CastlingPromotionAndSetPiece) {
+    Board board;
+    board.clear();
+    board.setPiece(0, 4, Piece(PieceType::King, Color::White));
+    board.setPiece(0, 7, Piece(PieceType::Rook, Color::White));
+    board.setPiece(6, 0, Piece(PieceType::Pawn, Color::White));
+
+    board.applyMove(Move(0, 4, 0, 6, std::nullopt, true));
+    EXPECT_EQ(board.pieceAt(0, 5)->type(), PieceType::Rook);
+    EXPECT_FALSE(board.pieceAt(0, 7).has_value());
+
+    board.applyMove(Move(6, 0, 7, 0, PieceType::Queen));
+    EXPECT_EQ(board.pieceAt(7, 0)->type(), PieceType::Queen);
+    EXPECT_EQ(board.pieces(PieceType::Pawn), 0ULL);
+
+    board.setPiece(7, 0, std::nullopt);
+    EXPECT_EQ(bb::popCount(board.occupied()), 2);
+}
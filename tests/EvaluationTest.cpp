@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+#include "../src/GameState.h"
+#include "../src/MoveGen.h"
+#include "../src/Perft.h"
+#include "../src/Psqt.h"
+#include "../src/Zobrist.h"
+#include "../src/engine/Evaluation.h"
+#include "../src/engine/PawnStructure.h"
+
+namespace {
+    Psqt::Score recompute(const Board &board, int &phase, std::uint64_t &pawnKey) {
+        Psqt::Score score;
+        phase = 0;
+        pawnKey = 0;
+        Bitboard occupied = board.occupied();
+        while (occupied) {
+            const int sq = bb::popLsb(occupied);
+            const Piece piece = *board.pieceOn(sq);
+            score += Psqt::piece(piece, sq);
+            phase += Psqt::phase(piece);
+            if (piece.type() == PieceType::Pawn) pawnKey ^= Zobrist::piece(piece, sq);
+        }
+        return score;
+    }
+
+    void walk(GameState &state, int depth) {
+        int phase = 0;
+        std::uint64_t pawnKey = 0;
+        const Psqt::Score expected = recompute(state.board(), phase, pawnKey);
+        ASSERT_EQ(state.board().psq(), expected) << state.fenFull();
+        ASSERT_EQ(state.board().phase(), phase) << state.fenFull();
+        ASSERT_EQ(state.pawnKey(), pawnKey) << state.fenFull();
+        if (depth == 0) return;
+        MoveList moves;
+        MoveGenerator::generateLegal(state, moves);
+        GameState::UndoInfo undo;
+        for (PackedMove m: moves) {
+            state.makeMove(m, undo);
+            walk(state, depth - 1);
+            state.unmakeMove(m, undo);
+        }
+    }
+}
+
+TEST(EvaluationTest, IncrementalScoresMatchRecomputation) {
+    // все виды ходов: рокировки, взятия на проходе, превращения
+    for (const auto &ref: Perft::referencePositions()) {
+        auto state = GameState::fromFEN(ref.fen);
+        ASSERT_TRUE(state.has_value()) << ref.name;
+        walk(*state, 3);
+    }
+}
+
+TEST(EvaluationTest, MirroredPositionsScoreEqually) {
+    auto white = GameState::fromFEN("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    auto black = GameState::fromFEN("r3k2r/pppbbppp/2n2q1P/1P2p3/3pn3/BN2PNP1/P1PPQPB1/R3K2R b KQkq - 0 1");
+    ASSERT_TRUE(white.has_value());
+    ASSERT_TRUE(black.has_value());
+    EXPECT_EQ(Evaluation::evaluate(*white), Evaluation::evaluate(*black));
+}
+
+TEST(EvaluationTest, TaperBlendsByPhase) {
+    const Psqt::Score score{100, -100};
+    EXPECT_EQ(Evaluation::taper(score, Psqt::MAX_PHASE), 100);
+    EXPECT_EQ(Evaluation::taper(score, 0), -100);
+    EXPECT_EQ(Evaluation::taper(score, Psqt::MAX_PHASE / 2), 0);
+    // после превращений фаза может превысить максимум
+    EXPECT_EQ(Evaluation::taper(score, Psqt::MAX_PHASE + 8), 100);
+
+    GameState start;
+    EXPECT_EQ(start.board().phase(), Psqt::MAX_PHASE);
+    auto endgame = GameState::fromFEN("4k3/8/8/8/8/8/4P3/4K3 w - - 0 1");
+    ASSERT_TRUE(endgame.has_value());
+    EXPECT_EQ(endgame->board().phase(), 0);
+    EXPECT_GT(Evaluation::evaluate(*endgame), 0);
+}
+
+TEST(EvaluationTest, PawnStructureTerms) {
+    Bitboard passed[2];
+    // проходная e5 у белых, сдвоенные изолированные пешки c у чёрных
+    auto state = GameState::fromFEN("4k3/2p5/2p5/4P3/8/8/8/4K3 w - - 0 1");
+    ASSERT_TRUE(state.has_value());
+    const Psqt::Score score = PawnStructure::evaluatePawns(state->board(), passed);
+    EXPECT_EQ(passed[0], bb::squareBB(bb::square(4, 4)));
+    EXPECT_EQ(passed[1], bb::squareBB(bb::square(5, 2)));
+    EXPECT_GT(score.eg, 0);
+
+    // отсталая пешка d2: соседи ушли вперёд, поле d3 бьёт пешка e4
+    auto backward = GameState::fromFEN("4k3/8/8/8/2P1p3/8/3P4/4K3 w - - 0 1");
+    auto free = GameState::fromFEN("4k3/8/8/4p3/2P5/8/3P4/4K3 w - - 0 1");
+    ASSERT_TRUE(backward.has_value());
+    ASSERT_TRUE(free.has_value());
+    EXPECT_LT(PawnStructure::evaluatePawns(backward->board(), passed).mg,
+              PawnStructure::evaluatePawns(free->board(), passed).mg);
+}
+
+TEST(EvaluationTest, PawnShieldRewardsPawnsBeforeKing) {
+    auto sheltered = GameState::fromFEN("6k1/8/8/8/8/8/5PPP/6K1 w - - 0 1");
+    auto exposed = GameState::fromFEN("6k1/8/8/8/8/8/PPP5/6K1 w - - 0 1");
+    ASSERT_TRUE(sheltered.has_value());
+    ASSERT_TRUE(exposed.has_value());
+    EXPECT_EQ(PawnStructure::evaluateShield(sheltered->board()).mg, 42);
+    EXPECT_EQ(PawnStructure::evaluateShield(exposed->board()).mg, 0);
+}
+
+TEST(EvaluationTest, PawnCacheMatchesDirectEvaluation) {
+    PawnCache cache(1024);
+    for (const auto &ref: Perft::referencePositions()) {
+        auto state = GameState::fromFEN(ref.fen);
+        ASSERT_TRUE(state.has_value()) << ref.name;
+        MoveList moves;
+        MoveGenerator::generateLegal(*state, moves);
+        GameState::UndoInfo undo;
+        for (PackedMove m: moves) {
+            state->makeMove(m, undo);
+            EXPECT_EQ(Evaluation::evaluate(*state, cache), Evaluation::evaluate(*state)) << ref.name;
+            state->unmakeMove(m, undo);
+        }
+    }
+    // большинство ходов не трогает пешки
+    EXPECT_GT(cache.hits() * 2, cache.probes());
+}
@@ -34,4 +34,92 @@ TEST(GameStateTest, EnPassantState) {
     ASSERT_TRUE(epTarget.has_value());
     EXPECT_EQ(epTarget->first, 2);
     EXPECT_EQ(epTarget->second, 0);
-}
\ No newline at end of file
+}
+TEST(GameStateTest, MakeUnmakeRestoresPosition) {
+    GameState state;
+    state.applyMove(Move(1, 4, 3, 4));  // e4
+    state.applyMove(Move(6, 0, 5, 0));  // a6
+    state.applyMove(Move(3, 4, 4, 4));  // e5
+    state.applyMove(Move(6, 3, 4, 3));  // d5
+    const std::string before = state.fenFull();
+
+    Move ep(4, 4, 5, 3, std::nullopt, false, true);  // exd6 e.p.
+    GameState::UndoInfo undo;
+    state.makeMove(ep, undo);
+    EXPECT_FALSE(state.board().pieceAt(4, 3).has_value());
+    EXPECT_EQ(state.sideToMove(), Color::Black);
+
+    state.unmakeMove(ep, undo);
+    EXPECT_EQ(state.fenFull(), before);
+    EXPECT_EQ(state.history().size(), 4u);
+}
+
+TEST(GameStateTest, FenRoundTrip) {
+    const std::string fen = "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R b Kq e3 3 17";
+    auto state = GameState::fromFEN(fen);
+    ASSERT_TRUE(state.has_value());
+    EXPECT_EQ(state->fenFull(), fen);
+    EXPECT_EQ(state->sideToMove(), Color::Black);
+    EXPECT_FALSE(state->canCastleQueenSide(Color::White));
+
+    EXPECT_FALSE(GameState::fromFEN("rnbqkbnr/pppppppp/9/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1").has_value());
+    EXPECT_FALSE(GameState::fromFEN("not a fen").has_value());
+}
+
+TEST(GameStateTest, FenRejectsUnplayablePositions) {
+    // пешки на крайних горизонталях
+    EXPECT_FALSE(GameState::fromFEN("4k2P/8/8/8/8/8/8/4K3 w - - 0 1").has_value());
+    EXPECT_FALSE(GameState::fromFEN("4k3/8/8/8/8/8/8/p3K3 b - - 0 1").has_value());
+    // поле взятия на проходе не на той горизонтали для стороны, делающей ход
+    EXPECT_FALSE(GameState::fromFEN("4k3/8/8/3pP3/8/8/8/4K3 w - d3 0 1").has_value());
+    EXPECT_FALSE(GameState::fromFEN("4k3/8/8/8/3Pp3/8/8/4K3 b - d6 0 1").has_value());
+    EXPECT_TRUE(GameState::fromFEN("4k3/8/8/8/3Pp3/8/8/4K3 b - d3 0 1").has_value());
+    // ровно один король у каждой стороны
+    EXPECT_FALSE(GameState::fromFEN("8/8/8/8/8/8/8/4K3 w - - 0 1").has_value());
+    EXPECT_FALSE(GameState::fromFEN("4k3/8/8/8/8/8/8/3KK3 w - - 0 1").has_value());
+}
+
+TEST(GameStateTest, ZobristKeyIsIncremental) {
+    GameState state;
+    const std::uint64_t start = state.key();
+    state.applyMove(Move(0, 6, 2, 5));  // Кg1-f3
+    state.applyMove(Move(7, 6, 5, 5));  // Кg8-f6
+    EXPECT_NE(state.key(), start);
+
+    auto fresh = GameState::fromFEN(state.fenFull());
+    ASSERT_TRUE(fresh.has_value());
+    EXPECT_EQ(fresh->key(), state.key());
+
+    state.undoMove();
+    state.undoMove();
+    EXPECT_EQ(state.key(), start);
+}
+
+TEST(GameStateTest, ThreefoldByKnightShuffle) {
+    GameState state;
+    for (int i = 0; i < 2; ++i) {
+        state.applyMove(Move(0, 6, 2, 5));  // Кg1-f3
+        state.applyMove(Move(7, 6, 5, 5));  // Кg8-f6
+        state.applyMove(Move(2, 5, 0, 6));  // Кf3-g1
+        state.applyMove(Move(5, 5, 7, 6));  // Кf6-g8
+    }
+    EXPECT_EQ(state.repetitionCount(), 3);
+    EXPECT_TRUE(state.isRepetition());
+}
+
+TEST(GameStateTest, UndoRestoresIrreversibleState) {
+    auto state = GameState::fromFEN("r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 5 20");
+    ASSERT_TRUE(state.has_value());
+    const std::string start = state->fenFull();
+
+    state->applyMove(Move(0, 0, 7, 0));  // Лa1xa8
+    state->applyMove(Move(7, 4, 7, 6, std::nullopt, true));  // O-O
+    EXPECT_FALSE(state->canCastleQueenSide(Color::White));
+    EXPECT_FALSE(state->canCastleQueenSide(Color::Black));
+    EXPECT_EQ(state->halfmoveClock(), 1);
+
+    EXPECT_TRUE(state->undoMove());
+    EXPECT_TRUE(state->undoMove());
+    EXPECT_FALSE(state->undoMove());
+    EXPECT_EQ(state->fenFull(), start);
+}
@@ -53,4 +53,61 @@ TEST(MoveGenTest, CastlingGeneration) {
         }
     }
     EXPECT_TRUE(castlingFound);
-}
\ No newline at end of file
+}
+TEST(MoveGenTest, SingleOriginSquare) {
+    GameState state;
+    MoveList knight;
+    MoveGenerator::generateLegal(state, 0, 6, knight);  // Кg1
+    EXPECT_EQ(knight.size(), 2u);
+    EXPECT_TRUE(knight.contains(PackedMove(bb::square(0, 6), bb::square(2, 5))));
+
+    MoveList empty;
+    MoveGenerator::generateLegal(state, 3, 3, empty);
+    EXPECT_TRUE(empty.empty());
+
+    MoveList all;
+    MoveGenerator::generateLegal(state, all);
+    EXPECT_EQ(all.size(), 20u);
+}
+
+namespace {
+    bool seeFromFen(const std::string &fen, const std::string &uci, int threshold) {
+        auto state = GameState::fromFEN(fen);
+        EXPECT_TRUE(state.has_value()) << fen;
+        auto move = Move::fromUCIInPosition(uci, *state);
+        EXPECT_TRUE(move.has_value()) << uci;
+        return MoveGenerator::see(state->board(), PackedMove(*move), threshold);
+    }
+}
+
+TEST(MoveGenTest, StaticExchangeEvaluation) {
+    // незащищённая пешка: +100
+    const std::string free = "1k1r4/1pp4p/p7/4p3/8/P5P1/1PP4P/2K1R3 w - - 0 1";
+    EXPECT_TRUE(seeFromFen(free, "e1e5", 100));
+    EXPECT_FALSE(seeFromFen(free, "e1e5", 101));
+
+    // конь за пешку: 100 - 320
+    const std::string knight = "1k1r3q/1ppn3p/p4b2/4p3/8/P2N2P1/1PP1R1BP/2K1Q3 w - - 0 1";
+    EXPECT_TRUE(seeFromFen(knight, "d3e5", -220));
+    EXPECT_FALSE(seeFromFen(knight, "d3e5", -219));
+
+    // рентген: ладья d1 поддерживает взятие, ферзю невыгодно отбирать
+    const std::string xray = "3q3k/8/8/3r4/8/8/3R4/3RK3 w - - 0 1";
+    EXPECT_TRUE(seeFromFen(xray, "d2d5", 500));
+    EXPECT_FALSE(seeFromFen(xray, "d2d5", 501));
+    const std::string noXray = "3q3k/8/8/3r4/8/8/3R4/4K3 w - - 0 1";
+    EXPECT_TRUE(seeFromFen(noXray, "d2d5", 0));
+    EXPECT_FALSE(seeFromFen(noXray, "d2d5", 1));
+
+    // связанный конь не может отыграть
+    const std::string pinned = "4k3/8/8/4n3/2p5/8/Q7/4R1K1 w - - 0 1";
+    EXPECT_TRUE(seeFromFen(pinned, "a2c4", 100));
+}
+
+TEST(MoveGenTest, AttackersToSquare) {
+    GameState state;
+    // f3 атакуют пешки e2, g2 и конь g1
+    const Bitboard attackers = MoveGenerator::attackersTo(state.board(), bb::square(2, 5), state.board().occupied());
+    EXPECT_EQ(bb::popCount(attackers), 3);
+    EXPECT_TRUE(attackers & bb::squareBB(bb::square(0, 6)));
+}
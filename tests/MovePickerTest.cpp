@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include "../src/GameState.h"
+#include "../src/MoveGen.h"
+#include "../src/MovePicker.h"
+#include "../src/Perft.h"
+
+namespace {
+    std::vector<PackedMove> drain(MovePicker &picker) {
+        std::vector<PackedMove> result;
+        while (const PackedMove m = picker.next()) result.push_back(m);
+        return result;
+    }
+
+    std::vector<std::uint16_t> sortedRaw(const std::vector<PackedMove> &moves) {
+        std::vector<std::uint16_t> raw;
+        for (PackedMove m: moves) raw.push_back(m.raw());
+        std::sort(raw.begin(), raw.end());
+        return raw;
+    }
+}
+
+TEST(MovePickerTest, CapturesAndQuietsPartitionLegalMoves) {
+    for (const auto &ref: Perft::referencePositions()) {
+        auto state = GameState::fromFEN(ref.fen);
+        ASSERT_TRUE(state.has_value()) << ref.name;
+        MoveList all, captures, quiets;
+        MoveGenerator::generateLegal(*state, all);
+        MoveGenerator::generateLegal(*state, captures, MoveGenerator::GenType::Captures);
+        MoveGenerator::generateLegal(*state, quiets, MoveGenerator::GenType::Quiets);
+        EXPECT_EQ(captures.size() + quiets.size(), all.size()) << ref.name;
+        for (PackedMove m: captures) EXPECT_FALSE(quiets.contains(m)) << ref.name;
+    }
+}
+
+TEST(MovePickerTest, YieldsEveryLegalMoveOnce) {
+    for (const auto &ref: Perft::referencePositions()) {
+        auto state = GameState::fromFEN(ref.fen);
+        ASSERT_TRUE(state.has_value()) << ref.name;
+        MoveList legal;
+        MoveGenerator::generateLegal(*state, legal);
+        std::vector<PackedMove> expected(legal.begin(), legal.end());
+
+        // эвристики из другой позиции: часть ходов нелегальна здесь
+        MoveHeuristics heuristics;
+        heuristics.killers[3] = {PackedMove(bb::square(0, 1), bb::square(2, 2)), legal[legal.size() - 1]};
+        heuristics.counterMoves[12][28] = legal[legal.size() / 2];
+        const PackedMove previous(12, 28);
+        MovePicker picker(*state, legal[0], &heuristics, 3, previous);
+        const auto picked = drain(picker);
+        EXPECT_EQ(sortedRaw(picked), sortedRaw(expected)) << ref.name;
+        EXPECT_EQ(picked.front(), legal[0]) << ref.name;
+
+        MovePicker bogus(*state, PackedMove(bb::square(4, 4), bb::square(4, 4)), nullptr, 0, PackedMove{});
+        EXPECT_EQ(sortedRaw(drain(bogus)), sortedRaw(expected)) << ref.name;
+    }
+}
+
+TEST(MovePickerTest, OrdersCapturesBeforeQuiets) {
+    // пешка может взять ферзя или ладью, ладья может взять пешку под защитой
+    auto state = GameState::fromFEN("4k3/8/2p4R/1q1r4/2P5/8/8/4K3 w - - 0 1");
+    ASSERT_TRUE(state.has_value());
+    MoveHeuristics heuristics;
+    MovePicker picker(*state, PackedMove{}, &heuristics, 0, PackedMove{});
+    const auto picked = drain(picker);
+    ASSERT_GE(picked.size(), 3u);
+    EXPECT_EQ(picked[0].toUCI(), "c4b5");
+    EXPECT_EQ(picked[1].toUCI(), "c4d5");
+    // взятие ладьёй защищённой пешки идёт последним
+    EXPECT_EQ(picked.back().toUCI(), "h6c6");
+}
+
+TEST(MovePickerTest, QuiescenceSkipsQuietMoves) {
+    auto state = GameState::fromFEN("4k3/P7/8/3p4/4P3/8/8/4K3 w - - 0 1");
+    ASSERT_TRUE(state.has_value());
+    MovePicker picker(*state, PackedMove{});
+    std::vector<std::string> uci;
+    for (PackedMove m: drain(picker)) uci.push_back(m.toUCI());
+    EXPECT_EQ(uci, (std::vector<std::string>{"a7a8q", "e4d5"}));
+}
+
+TEST(MovePickerTest, HistoryRaisesCutoffMoves) {
+    MoveHeuristics heuristics;
+    const PackedMove good(bb::square(0, 6), bb::square(2, 5));
+    const PackedMove bad(bb::square(1, 4), bb::square(3, 4));
+    heuristics.onQuietCutoff(Color::White, 2, good, PackedMove{}, 6, &bad, 1);
+    EXPECT_GT(heuristics.historyScore(Color::White, good), 0);
+    EXPECT_LT(heuristics.historyScore(Color::White, bad), 0);
+    EXPECT_EQ(heuristics.killers[2][0], good);
+
+    GameState state;
+    MovePicker picker(state, PackedMove{}, &heuristics, 5, PackedMove{});
+    EXPECT_EQ(picker.next(), good);
+}
@@ -0,0 +1,29 @@
+#include <gtest/gtest.h>
+#include "../src/PackedMove.h"
+
+TEST(PackedMoveTest, RoundTripThroughMove) {
+    Move promo(6, 1, 7, 0, PieceType::Knight);
+    PackedMove packed(promo);
+    EXPECT_EQ(packed.from(), bb::square(6, 1));
+    EXPECT_EQ(packed.to(), bb::square(7, 0));
+    EXPECT_TRUE(packed.isPromotion());
+    EXPECT_EQ(packed.promotionType(), PieceType::Knight);
+    EXPECT_TRUE(packed.toMove().sameSquaresAndPromo(promo));
+    EXPECT_EQ(packed.toUCI(), "b7a8n");
+
+    Move castle(0, 4, 0, 6, std::nullopt, true);
+    EXPECT_TRUE(PackedMove(castle).isCastling());
+    EXPECT_TRUE(PackedMove(castle).toMove().isCastling);
+
+    Move ep(4, 4, 5, 3, std::nullopt, false, true);
+    EXPECT_TRUE(PackedMove(ep).toMove().isEnPassant);
+}
+
+TEST(PackedMoveTest, UciParsing) {
+    auto m = PackedMove::fromUCI("e7e8q");
+    ASSERT_TRUE(m.has_value());
+    EXPECT_EQ(m->promotionType(), PieceType::Queen);
+    EXPECT_EQ(PackedMove::fromRaw(m->raw()), *m);
+    EXPECT_FALSE(PackedMove::fromUCI("e9e8").has_value());
+    EXPECT_FALSE(static_cast<bool>(PackedMove()));
+}
@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+#include "../src/GameState.h"
+#include "../src/Perft.h"
+
+namespace {
+    std::uint64_t perftFromFen(const std::string &fen, int depth) {
+        auto state = GameState::fromFEN(fen);
+        EXPECT_TRUE(state.has_value()) << fen;
+        return state ? Perft::run(*state, depth) : 0;
+    }
+}
+
+TEST(PerftTest, ReferencePositions) {
+    for (const auto &ref: Perft::referencePositions()) {
+        EXPECT_EQ(perftFromFen(ref.fen, ref.depth), ref.nodes) << ref.name;
+    }
+}
+
+TEST(PerftTest, EnPassantEdgeCases) {
+    // нелегальное взятие на проходе (связка по горизонтали)
+    EXPECT_EQ(perftFromFen("3k4/3p4/8/K1P4r/8/8/8/8 b - - 0 1", 6), 1134888u);
+    EXPECT_EQ(perftFromFen("8/8/4k3/8/2p5/8/B2P2K1/8 w - - 0 1", 6), 1015133u);
+    // взятие на проходе объявляет шах
+    EXPECT_EQ(perftFromFen("8/8/1k6/2b5/2pP4/8/5K2/8 b - d3 0 1", 6), 1440467u);
+}
+
+TEST(PerftTest, CastlingEdgeCases) {
+    EXPECT_EQ(perftFromFen("5k2/8/8/8/8/8/8/4K2R w K - 0 1", 6), 661072u);
+    EXPECT_EQ(perftFromFen("3k4/8/8/8/8/8/8/R3K3 w Q - 0 1", 6), 803711u);
+    EXPECT_EQ(perftFromFen("r3k2r/1b4bq/8/8/8/8/7B/R3K2R w KQkq - 0 1", 4), 1274206u);
+    EXPECT_EQ(perftFromFen("r3k2r/8/3Q4/8/8/5q2/8/R3K2R b KQkq - 0 1", 4), 1720476u);
+}
+
+TEST(PerftTest, PromotionAndCheckEdgeCases) {
+    EXPECT_EQ(perftFromFen("2K2r2/4P3/8/8/8/8/8/3k4 w - - 0 1", 6), 3821001u);
+    EXPECT_EQ(perftFromFen("8/8/1P2K3/8/2n5/1q6/8/5k2 b - - 0 1", 5), 1004658u);
+    EXPECT_EQ(perftFromFen("4k3/1P6/8/8/8/8/K7/8 w - - 0 1", 6), 217342u);
+    EXPECT_EQ(perftFromFen("8/P1k5/K7/8/8/8/8/8 w - - 0 1", 6), 92683u);
+    EXPECT_EQ(perftFromFen("K1k5/8/P7/8/8/8/8/8 w - - 0 1", 6), 2217u);
+    EXPECT_EQ(perftFromFen("8/k1P5/8/1K6/8/8/8/8 w - - 0 1", 7), 567584u);
+    EXPECT_EQ(perftFromFen("8/8/2k5/5q2/5n2/8/5K2/8 b - - 0 1", 4), 23527u);
+}
+
+TEST(PerftTest, DivideSumsToTotal) {
+    GameState state;
+    auto entries = Perft::divide(state, 3);
+    EXPECT_EQ(entries.size(), 20u);
+    std::uint64_t sum = 0;
+    for (const auto &e: entries) sum += e.nodes;
+    EXPECT_EQ(sum, 8902u);
+}
+
+TEST(PerftTest, ParallelMatchesSerial) {
+    auto state = GameState::fromFEN("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    ASSERT_TRUE(state.has_value());
+    EXPECT_EQ(Perft::runParallel(*state, 3, 4), 97862u);
+    EXPECT_EQ(Perft::runParallel(*state, 4, 4), 4085603u);
+
+    std::uint64_t sum = 0;
+    for (const auto &e: Perft::divide(*state, 3, 4)) sum += e.nodes;
+    EXPECT_EQ(sum, 97862u);
+}
+
+TEST(PerftTest, ParallelDivideMatchesSerialRunPerMove) {
+    // каждая ветка, посчитанная в потоках, совпадает с однопоточным run из дочерней позиции
+    auto state = GameState::fromFEN("r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10");
+    ASSERT_TRUE(state.has_value());
+    for (int round = 0; round < 3; ++round) {
+        std::uint64_t total = 0;
+        for (const auto &e: Perft::divide(*state, 3, 8)) {
+            GameState child = *state;
+            GameState::UndoInfo undo;
+            child.makeMove(e.move, undo);
+            EXPECT_EQ(e.nodes, Perft::run(child, 2)) << e.move.toUCI();
+            total += e.nodes;
+        }
+        EXPECT_EQ(total, Perft::run(*state, 3));
+        EXPECT_EQ(Perft::runParallel(*state, 3, 8), total);
+    }
+}
@@ -0,0 +1,46 @@
+#include <gtest/gtest.h>
+#include "../src/GameState.h"
+#include "../src/MoveGen.h"
+#include "../src/San.h"
+
+namespace {
+    std::string san(const std::string &fen, const std::string &uci) {
+        auto state = GameState::fromFEN(fen);
+        EXPECT_TRUE(state.has_value()) << fen;
+        if (!state) return {};
+        MoveList moves;
+        MoveGenerator::generateLegal(*state, moves);
+        for (PackedMove move: moves) {
+            if (move.toUCI() == uci) return San::fromMove(*state, move);
+        }
+        ADD_FAILURE() << uci << " is not legal in " << fen;
+        return {};
+    }
+}
+
+TEST(SanTest, PiecesPawnsAndCaptures) {
+    const std::string start = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+    EXPECT_EQ(san(start, "e2e4"), "e4");
+    EXPECT_EQ(san(start, "g1f3"), "Nf3");
+    EXPECT_EQ(san("4k3/8/8/3p4/4P3/8/8/4K3 w - - 0 1", "e4d5"), "exd5");
+    EXPECT_EQ(san("4k3/8/8/3Pp3/8/8/8/4K3 w - e6 0 1", "d5e6"), "dxe6");
+}
+
+TEST(SanTest, CastlingAndPromotion) {
+    EXPECT_EQ(san("r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 0 1", "e1g1"), "O-O");
+    EXPECT_EQ(san("r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 0 1", "e1c1"), "O-O-O");
+    EXPECT_EQ(san("1n2k3/P7/8/8/8/8/8/4K3 w - - 0 1", "a7b8n"), "axb8=N");
+}
+
+TEST(SanTest, Disambiguation) {
+    // кони на b1 и f1 идут на d2; ладьи на a1 и a5 — на a3
+    EXPECT_EQ(san("4k3/8/8/8/8/8/8/1N2KN2 w - - 0 1", "b1d2"), "Nbd2");
+    EXPECT_EQ(san("4k3/8/8/R7/8/8/8/R3K3 w - - 0 1", "a1a3"), "R1a3");
+    // три ферзя бьют одно поле: нужны и вертикаль, и горизонталь
+    EXPECT_EQ(san("1k6/8/8/8/Q6Q/8/8/K6Q w - - 0 1", "h4e4"), "Qh4e4");
+}
+
+TEST(SanTest, CheckAndMateSuffixes) {
+    EXPECT_EQ(san("6k1/5ppp/8/8/8/8/8/R5K1 w - - 0 1", "a1a8"), "Ra8#");
+    EXPECT_EQ(san("6k1/8/8/8/8/8/8/R5K1 w - - 0 1", "a1a8"), "Ra8+");
+}
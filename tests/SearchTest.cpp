@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+#include "../src/GameState.h"
+#include "../src/MoveGen.h"
+#include "../src/engine/Evaluation.h"
+#include "../src/engine/ParallelSearch.h"
+#include "../src/engine/Search.h"
+
+namespace {
+    PackedMove bestMoveFor(const std::string &fen, int depth) {
+        auto state = GameState::fromFEN(fen);
+        EXPECT_TRUE(state.has_value()) << fen;
+        if (!state) return {};
+        TranspositionTable tt(1);
+        Search search(tt);
+        Search::Limits limits;
+        limits.maxDepth = depth;
+        return search.think(*state, limits);
+    }
+}
+
+TEST(SearchTest, StartPositionIsBalanced) {
+    GameState state;
+    EXPECT_EQ(Evaluation::evaluate(state), 0);
+}
+
+TEST(SearchTest, FindsMateInOne) {
+    // мат по последней горизонтали
+    EXPECT_EQ(bestMoveFor("6k1/5ppp/8/8/8/8/8/R5K1 w - - 0 1", 3).toUCI(), "a1a8");
+    EXPECT_EQ(bestMoveFor("r5k1/8/8/8/8/8/5PPP/6K1 b - - 0 1", 3).toUCI(), "a8a1");
+}
+
+TEST(SearchTest, ReportsMateScore) {
+    auto state = GameState::fromFEN("6k1/5ppp/8/8/8/8/8/R5K1 w - - 0 1");
+    ASSERT_TRUE(state.has_value());
+    TranspositionTable tt(1);
+    Search search(tt);
+    Search::Limits limits;
+    limits.maxDepth = 4;
+    Search::Info last;
+    search.think(*state, limits, [&](const Search::Info &info) { last = info; });
+    ASSERT_TRUE(Search::isMateScore(last.score));
+    EXPECT_EQ(Search::mateInMoves(last.score), 1);
+    ASSERT_FALSE(last.pv.empty());
+    EXPECT_EQ(last.pv.front().toUCI(), "a1a8");
+}
+
+TEST(SearchTest, WinsHangingQueen) {
+    EXPECT_EQ(bestMoveFor("4k3/8/8/3q4/8/8/3R4/4K3 w - - 0 1", 3).toUCI(), "d2d5");
+}
+
+TEST(SearchTest, NoMoveWhenMatedOrStalemated) {
+    EXPECT_FALSE(bestMoveFor("R5k1/5ppp/8/8/8/8/8/6K1 b - - 0 1", 3));
+    EXPECT_FALSE(bestMoveFor("7k/5Q2/6K1/8/8/8/8/8 b - - 0 1", 3));
+}
+
+TEST(SearchTest, NodeLimitStopsSearch) {
+    GameState state;
+    TranspositionTable tt(1);
+    Search search(tt);
+    Search::Limits limits;
+    limits.maxNodes = 5000;
+    const PackedMove best = search.think(state, limits);
+    EXPECT_TRUE(best);
+    EXPECT_LE(search.nodes(), 5000u);
+}
+
+TEST(SearchTest, LazySmpAgreesOnTacticalMoves) {
+    TranspositionTable tt(4);
+    ParallelSearch search(tt, 4);
+    EXPECT_EQ(search.threads(), 4);
+    Search::Limits limits;
+    limits.maxDepth = 4;
+
+    auto mate = GameState::fromFEN("6k1/5ppp/8/8/8/8/8/R5K1 w - - 0 1");
+    ASSERT_TRUE(mate.has_value());
+    EXPECT_EQ(search.think(*mate, limits).toUCI(), "a1a8");
+
+    auto queen = GameState::fromFEN("4k3/8/8/3q4/8/8/3R4/4K3 w - - 0 1");
+    ASSERT_TRUE(queen.has_value());
+    EXPECT_EQ(search.think(*queen, limits).toUCI(), "d2d5");
+}
+
+TEST(SearchTest, LazySmpStopsOnRequest) {
+    TranspositionTable tt(4);
+    ParallelSearch search(tt, 3);
+    GameState state;
+    PackedMove best;
+    bool done = false;
+    search.start(state, Search::Limits{}, {}, [&](PackedMove move) {
+        best = move;
+        done = true;
+    });
+    EXPECT_TRUE(search.isSearching());
+    search.stop();
+    search.wait();
+    EXPECT_TRUE(done);
+    EXPECT_TRUE(best);
+    EXPECT_GT(search.nodes(), 0u);
+}
+
+TEST(SearchTest, MultiPvReportsDistinctLinesInOrder) {
+    auto state = GameState::fromFEN("4k3/8/8/3q4/8/8/3R4/4K3 w - - 0 1");
+    ASSERT_TRUE(state.has_value());
+    TranspositionTable tt(1);
+    Search search(tt);
+    Search::Limits limits;
+    limits.maxDepth = 4;
+    limits.multiPv = 3;
+    std::vector<Search::Info> lastDepth;
+    const PackedMove best = search.think(*state, limits, [&](const Search::Info &info) {
+        if (info.multiPv == 1) lastDepth.clear();
+        lastDepth.push_back(info);
+    });
+    ASSERT_EQ(lastDepth.size(), 3u);
+    EXPECT_EQ(best.toUCI(), "d2d5");
+    EXPECT_EQ(lastDepth[0].pv.front(), best);
+    for (int i = 0; i < 3; ++i) EXPECT_EQ(lastDepth[i].multiPv, i + 1);
+    // вторая и третья линии — другие ходы и не лучше первой
+    EXPECT_NE(lastDepth[1].pv.front(), lastDepth[0].pv.front());
+    EXPECT_NE(lastDepth[2].pv.front(), lastDepth[1].pv.front());
+    EXPECT_NE(lastDepth[2].pv.front(), lastDepth[0].pv.front());
+    EXPECT_GE(lastDepth[0].score, lastDepth[1].score);
+    EXPECT_GE(lastDepth[1].score, lastDepth[2].score);
+}
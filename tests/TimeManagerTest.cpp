@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include "../src/GameState.h"
+#include "../src/engine/Search.h"
+#include "../src/engine/TimeManager.h"
+
+namespace {
+    TimeManager::Clock clock(std::int64_t remaining, std::int64_t increment = 0, int movesToGo = 0) {
+        TimeManager::Clock c;
+        c.remainingMs = remaining;
+        c.incrementMs = increment;
+        c.movesToGo = movesToGo;
+        return c;
+    }
+
+    PackedMove move(const std::string &uci) {
+        return PackedMove::fromUCI(uci).value_or(PackedMove());
+    }
+}
+
+TEST(TimeManagerTest, AllocatesFromClockIncrementAndMovesToGo) {
+    TimeManager tm;
+    tm.init(clock(60000));
+    const std::int64_t suddenDeath = tm.optimumMs();
+    EXPECT_GT(suddenDeath, 0);
+    EXPECT_LE(tm.maximumMs(), 60000 / 3);
+    EXPECT_GE(tm.maximumMs(), tm.optimumMs());
+
+    // прибавка увеличивает бюджет
+    tm.init(clock(60000, 2000));
+    EXPECT_GT(tm.optimumMs(), suddenDeath);
+
+    // перед контролем можно потратить почти всё оставшееся время
+    tm.init(clock(10000, 0, 1));
+    EXPECT_GT(tm.optimumMs(), 5000);
+    EXPECT_LT(tm.maximumMs(), 10000);
+
+    // почти без времени бюджет не уходит в ноль
+    tm.init(clock(20));
+    EXPECT_GE(tm.optimumMs(), 1);
+}
+
+TEST(TimeManagerTest, StableBestMoveStopsEarly) {
+    TimeManager tm;
+    tm.init(clock(60000));
+    const PackedMove e4 = move("e2e4");
+    for (int i = 0; i < 6; ++i) tm.iterationDone(e4, 20, 0);
+    EXPECT_LT(tm.targetMs(), tm.optimumMs());
+}
+
+TEST(TimeManagerTest, InstabilityAndScoreDropExtendTheBudget) {
+    TimeManager tm;
+    tm.init(clock(60000));
+    tm.iterationDone(move("e2e4"), 20, 0);
+    tm.iterationDone(move("d2d4"), 20, 0);
+    tm.iterationDone(move("g1f3"), 20, 0);
+    EXPECT_GT(tm.targetMs(), tm.optimumMs());
+
+    tm.init(clock(60000));
+    tm.iterationDone(move("e2e4"), 50, 0);
+    tm.iterationDone(move("e2e4"), -100, 0);
+    EXPECT_GT(tm.targetMs(), tm.optimumMs());
+    EXPECT_LE(tm.targetMs(), tm.maximumMs());
+}
+
+TEST(TimeManagerTest, SearchAnswersForcedMoveImmediately) {
+    // единственный ход королём
+    auto state = GameState::fromFEN("k7/8/8/8/8/8/1q6/K7 w - - 0 1");
+    ASSERT_TRUE(state.has_value());
+    TranspositionTable tt(1);
+    Search search(tt);
+    Search::Limits limits;
+    limits.clock = clock(600000);
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(search.think(*state, limits).toUCI(), "a1b2");
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    EXPECT_LT(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count(), 1000);
+}
+
+TEST(TimeManagerTest, SearchStaysWithinMaximum) {
+    GameState state;
+    TranspositionTable tt(1);
+    Search search(tt);
+    Search::Limits limits;
+    limits.clock = clock(1500);
+    TimeManager tm;
+    tm.init(limits.clock);
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_TRUE(search.think(state, limits));
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    EXPECT_LE(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count(), tm.maximumMs() + 200);
+}
@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+#include "../src/GameState.h"
+#include "../src/Perft.h"
+#include "../src/TranspositionTable.h"
+
+TEST(TranspositionTableTest, StoreAndProbe) {
+    TranspositionTable tt(1);
+    const auto move = PackedMove::fromUCI("e2e4");
+    ASSERT_TRUE(move.has_value());
+
+    TranspositionTable::Entry entry;
+    EXPECT_FALSE(tt.probe(0x1234567890abcdefULL, entry));
+
+    tt.store(0x1234567890abcdefULL, 7, TranspositionTable::Bound::Lower, *move, -31990);
+    ASSERT_TRUE(tt.probe(0x1234567890abcdefULL, entry));
+    EXPECT_EQ(entry.depth(), 7);
+    EXPECT_EQ(entry.bound(), TranspositionTable::Bound::Lower);
+    EXPECT_EQ(entry.move(), *move);
+    EXPECT_EQ(entry.score(), -31990);
+
+    // другой ключ не должен находить чужую запись
+    EXPECT_FALSE(tt.probe(0x1234567890abcdeeULL, entry));
+
+    tt.clear();
+    EXPECT_FALSE(tt.probe(0x1234567890abcdefULL, entry));
+}
+
+TEST(TranspositionTableTest, DeeperEntryIsKept) {
+    TranspositionTable tt(1);
+    const std::uint64_t key = 0xfeedfacecafebeefULL;
+    tt.store(key, 10, TranspositionTable::Bound::Lower, PackedMove{}, 50);
+    tt.store(key, 3, TranspositionTable::Bound::Upper, PackedMove{}, -20);
+
+    TranspositionTable::Entry entry;
+    ASSERT_TRUE(tt.probe(key, entry));
+    EXPECT_EQ(entry.depth(), 10);
+
+    // после новой итерации поиска старая запись уступает место
+    tt.newSearch();
+    tt.store(key, 3, TranspositionTable::Bound::Upper, PackedMove{}, -20);
+    ASSERT_TRUE(tt.probe(key, entry));
+    EXPECT_EQ(entry.depth(), 3);
+}
+
+TEST(TranspositionTableTest, HashfullGrowsAndResetsWithAge) {
+    TranspositionTable tt(1);
+    EXPECT_EQ(tt.hashfull(), 0);
+    for (std::uint64_t i = 1; i <= 200000; ++i) {
+        tt.storeCount(i * 0x9e3779b97f4a7c15ULL, 2, i);
+    }
+    EXPECT_GT(tt.hashfull(), 500);
+    tt.newSearch();
+    EXPECT_EQ(tt.hashfull(), 0);
+}
+
+TEST(TranspositionTableTest, HashPerftMatchesReference) {
+    TranspositionTable tt(16);
+    for (const auto &ref: Perft::referencePositions()) {
+        auto state = GameState::fromFEN(ref.fen);
+        ASSERT_TRUE(state.has_value()) << ref.name;
+        EXPECT_EQ(Perft::run(*state, ref.depth, &tt), ref.nodes) << ref.name;
+        EXPECT_EQ(Perft::runParallel(*state, ref.depth, 4, &tt), ref.nodes) << ref.name;
+    }
+}
@@ -0,0 +1,56 @@
+#include <gtest/gtest.h>
+#include "../src/engine/UciInfo.h"
+
+TEST(UciInfoTest, ParsesFullStockfishLine) {
+    auto info = UciInfo::parse(
+        "info depth 22 seldepth 31 multipv 2 score cp -35 upperbound nodes 1234567 nps 987654 "
+        "hashfull 412 tbhits 7 time 1250 pv e7e5 g1f3 b8c6\r\n");
+    ASSERT_TRUE(info.has_value());
+    EXPECT_EQ(info->depth, 22);
+    EXPECT_EQ(info->selDepth, 31);
+    EXPECT_EQ(info->multiPv, 2);
+    EXPECT_TRUE(info->hasScore);
+    EXPECT_FALSE(info->isMate);
+    EXPECT_EQ(info->score, -35);
+    EXPECT_EQ(info->bound, UciInfo::Bound::Upper);
+    EXPECT_EQ(info->nodes, 1234567u);
+    EXPECT_EQ(info->nps, 987654u);
+    EXPECT_EQ(info->hashfull, 412);
+    EXPECT_EQ(info->tbHits, 7u);
+    EXPECT_EQ(info->timeMs, 1250);
+    ASSERT_EQ(info->pv.size(), 3u);
+    EXPECT_EQ(info->pv[0].toUCI(), "e7e5");
+    EXPECT_EQ(info->pv[2].toUCI(), "b8c6");
+}
+
+TEST(UciInfoTest, ParsesMateScoresAndPromotions) {
+    auto info = UciInfo::parse("info depth 5 score mate -3 wdl 0 0 1000 pv a7a8q b1a1");
+    ASSERT_TRUE(info.has_value());
+    EXPECT_TRUE(info->isMate);
+    EXPECT_EQ(info->score, -3);
+    EXPECT_EQ(info->multiPv, 1);
+    ASSERT_EQ(info->pv.size(), 2u);
+    EXPECT_EQ(info->pv[0].toUCI(), "a7a8q");
+}
+
+TEST(UciInfoTest, PvMovesCarrySquaresOnly) {
+    // без позиции рокировку не отличить от хода короля: флаги не выставляются
+    auto info = UciInfo::parse("info depth 3 score cp 20 pv e1g1 e8c8 e5d6 h2h1n");
+    ASSERT_TRUE(info.has_value());
+    ASSERT_EQ(info->pv.size(), 4u);
+    EXPECT_EQ(info->pv[0], PackedMove(4, 6));
+    EXPECT_FALSE(info->pv[0].isCastling());
+    EXPECT_EQ(info->pv[1].toUCI(), "e8c8");
+    EXPECT_FALSE(info->pv[2].isEnPassant());
+    EXPECT_EQ(info->pv[3], PackedMove(15, 7, PackedMove::Promotion, PieceType::Knight));
+    // разбор останавливается на первом некорректном ходе
+    EXPECT_EQ(UciInfo::parse("info score cp 0 pv e2e4 e9e5 d2d4")->pv.size(), 1u);
+}
+
+TEST(UciInfoTest, RejectsLinesWithoutData) {
+    EXPECT_FALSE(UciInfo::parse("bestmove e2e4 ponder e7e5"));
+    EXPECT_FALSE(UciInfo::parse("info string NNUE evaluation using nn-1111.nnue"));
+    EXPECT_FALSE(UciInfo::parse("info depth 12 currmove e2e4 currmovenumber 1"));
+    EXPECT_FALSE(UciInfo::parse("info depth x score cp 10"));
+    EXPECT_FALSE(UciInfo::parse(""));
+}
@@ -0,0 +1,63 @@
+#include <gtest/gtest.h>
+#include "../src/engine/UciProtocol.h"
+
+TEST(UciProtocolTest, LineBufferJoinsChunks) {
+    UciProtocol::LineBuffer lines;
+    lines.append("id name Stock");
+    EXPECT_FALSE(lines.next().has_value());
+    // строка может прийти по частям, а \r\n — в конце
+    lines.append("fish\r\nuciok\nready");
+    EXPECT_EQ(lines.next(), "id name Stockfish");
+    EXPECT_EQ(lines.next(), "uciok");
+    EXPECT_FALSE(lines.next().has_value());
+    lines.append("ok\n");
+    EXPECT_EQ(lines.next(), "readyok");
+}
+
+TEST(UciProtocolTest, LineBufferDrainsLargeChunk) {
+    // один большой кусок вывода разбирается целиком, хвост без \n ждёт следующего куска
+    std::string chunk;
+    constexpr int LINES = 20000;
+    for (int i = 0; i < LINES; ++i) chunk += "info depth " + std::to_string(i) + " score cp 10 pv e2e4\n";
+    chunk += "bestmove e2";
+    UciProtocol::LineBuffer lines;
+    lines.append(chunk);
+    int count = 0;
+    while (auto line = lines.next()) {
+        EXPECT_EQ(*line, "info depth " + std::to_string(count) + " score cp 10 pv e2e4");
+        ++count;
+    }
+    EXPECT_EQ(count, LINES);
+    lines.append("e4\n");
+    EXPECT_EQ(lines.next(), "bestmove e2e4");
+    EXPECT_FALSE(lines.next().has_value());
+}
+
+TEST(UciProtocolTest, ParsesReplies) {
+    auto best = UciProtocol::parseBestMove("bestmove e2e4 ponder e7e5\r");
+    ASSERT_TRUE(best.has_value());
+    EXPECT_EQ(best->move, "e2e4");
+    EXPECT_EQ(best->ponder, "e7e5");
+    EXPECT_TRUE(best->hasMove());
+
+    best = UciProtocol::parseBestMove("bestmove (none)");
+    ASSERT_TRUE(best.has_value());
+    EXPECT_TRUE(best->ponder.empty());
+    EXPECT_FALSE(best->hasMove());
+    EXPECT_FALSE(UciProtocol::parseBestMove("info depth 1 pv e2e4").has_value());
+
+    EXPECT_EQ(UciProtocol::parseOptionName("option name Skill Level type spin default 20 min 0 max 20"),
+              "Skill Level");
+    EXPECT_EQ(UciProtocol::parseOptionName("option name Ponder type check default false"), "Ponder");
+    EXPECT_FALSE(UciProtocol::parseOptionName("id name Stockfish").has_value());
+}
+
+TEST(UciProtocolTest, BuildsCommands) {
+    EXPECT_EQ(UciProtocol::position("", {}), "position startpos");
+    EXPECT_EQ(UciProtocol::position("", {"e2e4", "e7e5"}), "position startpos moves e2e4 e7e5");
+    EXPECT_EQ(UciProtocol::position("4k3/8/8/8/8/8/8/4K3 w - - 0 1", {"e1e2"}),
+              "position fen 4k3/8/8/8/8/8/8/4K3 w - - 0 1 moves e1e2");
+    EXPECT_EQ(UciProtocol::setOption("UCI_Elo", "1200"), "setoption name UCI_Elo value 1200");
+    EXPECT_EQ(UciProtocol::clockArguments(60000, 59000, 1000, 1000), "wtime 60000 btime 59000 winc 1000 binc 1000");
+    EXPECT_EQ(UciProtocol::clockArguments(1, 2, 0, 0, 40), "wtime 1 btime 2 winc 0 binc 0 movestogo 40");
+}
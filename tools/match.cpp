@@ -0,0 +1,584 @@
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "../src/GameState.h"
+#include "../src/MoveGen.h"
+#include "../src/San.h"
+#include "../src/TranspositionTable.h"
+#include "../src/engine/Search.h"
+#include "../src/engine/UciProtocol.h"
+
+// Plays engines against each other without the GUI, e.g. to check that the Easy/Medium/Hard
+// Elo presets are actually ordered and spaced the way the menu claims.
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    const std::string STARTPOS = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+    // Short balanced openings, given as moves from the initial position; each is played twice with colours swapped.
+    const std::vector<std::string> DEFAULT_OPENINGS = {
+        "",
+        "e2e4 e7e5 g1f3 b8c6",
+        "e2e4 c7c5 g1f3 d7d6",
+        "e2e4 e7e6 d2d4 d7d5",
+        "e2e4 c7c6 d2d4 d7d5",
+        "d2d4 d7d5 c2c4 e7e6",
+        "d2d4 g8f6 c2c4 g7g6",
+        "c2c4 e7e5 b1c3 g8f6",
+    };
+
+    void printUsage() {
+        std::cerr << "usage: match --engine1 SPEC --engine2 SPEC [--games N] [--concurrency K]\n"
+                  << "             [--tc BASE_MS+INC_MS | --movetime MS] [--openings FILE] [--pgn FILE] [--maxplies N]\n"
+                  << "  SPEC is builtin[,elo=E|,depth=D][,hash=MB][,name=NAME]\n"
+                  << "       or cmd=PATH[,elo=E][,hash=MB][,name=NAME] for a UCI engine\n"
+                  << "  FILE for --openings holds one FEN per line\n";
+    }
+
+    struct EngineSpec {
+        std::string name;
+        std::string command;  // empty for the built-in search
+        int elo = 0;
+        int depth = 0;
+        int hashMb = 16;
+    };
+
+    struct TimeControl {
+        std::int64_t movetimeMs = 0;
+        std::int64_t baseMs = 0;
+        std::int64_t incrementMs = 0;
+    };
+
+    std::optional<EngineSpec> parseSpec(const std::string &text) {
+        EngineSpec spec;
+        std::istringstream in(text);
+        std::string field;
+        while (std::getline(in, field, ',')) {
+            const auto eq = field.find('=');
+            const std::string key = field.substr(0, eq);
+            const std::string value = eq == std::string::npos ? std::string() : field.substr(eq + 1);
+            if (key == "builtin" && eq == std::string::npos) spec.command.clear();
+            else if (key == "cmd") spec.command = value;
+            else if (key == "name") spec.name = value;
+            else if (key == "elo") spec.elo = std::atoi(value.c_str());
+            else if (key == "depth") spec.depth = std::atoi(value.c_str());
+            else if (key == "hash") spec.hashMb = std::max(1, std::atoi(value.c_str()));
+            else return std::nullopt;
+        }
+        if (spec.name.empty()) {
+            spec.name = spec.command.empty() ? "builtin" : spec.command.substr(spec.command.find_last_of('/') + 1);
+            if (spec.elo > 0) spec.name += " " + std::to_string(spec.elo);
+            else if (spec.depth > 0) spec.name += " d" + std::to_string(spec.depth);
+        }
+        return spec;
+    }
+
+    std::optional<std::string> fenAfter(const std::string &moves) {
+        auto state = GameState::fromFEN(STARTPOS);
+        std::istringstream in(moves);
+        std::string uci;
+        while (in >> uci) {
+            MoveList legal;
+            MoveGenerator::generateLegal(*state, legal);
+            const auto it = std::find_if(legal.begin(), legal.end(), [&](PackedMove m) { return m.toUCI() == uci; });
+            if (it == legal.end()) return std::nullopt;
+            state->applyMove(*it);
+        }
+        return state->fenFull();
+    }
+
+    class Player {
+    public:
+        virtual ~Player() = default;
+        virtual bool newGame() = 0;
+        // Returns the chosen move in UCI notation, or an empty string when the engine gave none in time.
+        virtual std::string bestMove(const std::string &startFen, const std::vector<std::string> &moves,
+                                     const GameState &state, const TimeControl &tc,
+                                     const std::int64_t clockMs[2]) = 0;
+    };
+
+    class BuiltinPlayer : public Player {
+    public:
+        explicit BuiltinPlayer(const EngineSpec &spec)
+            : tt_(spec.hashMb)
+            , search_(tt_)
+            , maxDepth_(spec.depth > 0 ? std::min(spec.depth, Search::MAX_PLY - 1)
+                        : spec.elo > 0 ? Search::depthForElo(spec.elo) : Search::MAX_PLY - 1) {
+        }
+
+        bool newGame() override {
+            tt_.clear();
+            return true;
+        }
+
+        std::string bestMove(const std::string &, const std::vector<std::string> &, const GameState &state,
+                             const TimeControl &tc, const std::int64_t clockMs[2]) override {
+            Search::Limits limits;
+            limits.maxDepth = maxDepth_;
+            if (tc.movetimeMs > 0) {
+                limits.movetimeMs = static_cast<int>(tc.movetimeMs);
+            } else if (tc.baseMs > 0) {
+                limits.clock.remainingMs = clockMs[static_cast<int>(state.sideToMove())];
+                limits.clock.incrementMs = tc.incrementMs;
+            }
+            tt_.newSearch();
+            const PackedMove move = search_.think(state, limits);
+            return move ? move.toUCI() : std::string();
+        }
+
+    private:
+        TranspositionTable tt_;
+        Search search_;
+        int maxDepth_;
+    };
+
+    class UciPlayer : public Player {
+    public:
+        explicit UciPlayer(EngineSpec spec)
+            : spec_(std::move(spec)) {
+        }
+
+        ~UciPlayer() override {
+            if (pid_ <= 0) return;
+            send("quit");
+            ::close(toEngine_);
+            ::close(fromEngine_);
+            for (int i = 0; i < 100; ++i) {
+                if (::waitpid(pid_, nullptr, WNOHANG) == pid_) return;
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+            ::kill(pid_, SIGKILL);
+            ::waitpid(pid_, nullptr, 0);
+        }
+
+        bool start() {
+            // Other workers may hold the allocator lock when this thread forks, so the child only
+            // makes async-signal-safe calls; everything it needs is prepared here.
+            const std::string command = "exec " + spec_.command;
+            // Close-on-exec keeps engines started by other workers from inheriting these pipes (and
+            // holding our engine's stdin open); dup2 clears the flag on the child's stdin and stdout.
+            int in[2], out[2];
+            if (::pipe2(in, O_CLOEXEC) != 0) return false;
+            if (::pipe2(out, O_CLOEXEC) != 0) {
+                ::close(in[0]);
+                ::close(in[1]);
+                return false;
+            }
+            pid_ = ::fork();
+            if (pid_ < 0) {
+                for (int fd: {in[0], in[1], out[0], out[1]}) ::close(fd);
+                return false;
+            }
+            if (pid_ == 0) {
+                ::dup2(in[0], STDIN_FILENO);
+                ::dup2(out[1], STDOUT_FILENO);
+                ::execl("/bin/sh", "sh", "-c", command.c_str(), static_cast<char *>(nullptr));
+                ::_exit(127);
+            }
+            ::close(in[0]);
+            ::close(out[1]);
+            toEngine_ = in[1];
+            fromEngine_ = out[0];
+
+            send("uci");
+            const auto deadline = Clock::now() + std::chrono::milliseconds(HANDSHAKE_MS);
+            for (;;) {
+                const auto line = readLine(deadline);
+                if (!line) return false;
+                if (*line == "uciok") break;
+                if (auto name = UciProtocol::parseOptionName(*line)) options_.push_back(std::move(*name));
+            }
+            setOption("Hash", std::to_string(spec_.hashMb));
+            if (spec_.elo > 0) {
+                if (!hasOption("UCI_Elo")) std::cerr << spec_.name << ": no UCI_Elo option, playing at full strength\n";
+                setOption("UCI_LimitStrength", "true");
+                setOption("UCI_Elo", std::to_string(spec_.elo));
+            }
+            return newGame();
+        }
+
+        bool newGame() override {
+            send("ucinewgame");
+            send("isready");
+            return waitFor("readyok", HANDSHAKE_MS);
+        }
+
+        std::string bestMove(const std::string &startFen, const std::vector<std::string> &moves, const GameState &,
+                             const TimeControl &tc, const std::int64_t clockMs[2]) override {
+            send(UciProtocol::position(startFen, moves));
+
+            std::int64_t budgetMs;
+            if (tc.movetimeMs > 0) {
+                send("go movetime " + std::to_string(tc.movetimeMs));
+                budgetMs = tc.movetimeMs;
+            } else {
+                send("go " + UciProtocol::clockArguments(clockMs[0], clockMs[1], tc.incrementMs, tc.incrementMs));
+                budgetMs = std::max(clockMs[0], clockMs[1]);
+            }
+            const auto deadline = Clock::now() + std::chrono::milliseconds(budgetMs + GRACE_MS);
+            while (auto line = readLine(deadline)) {
+                if (const auto best = UciProtocol::parseBestMove(*line))
+                    return best->hasMove() ? best->move : std::string();
+            }
+            return {};
+        }
+
+    private:
+        static constexpr int HANDSHAKE_MS = 10000;
+        static constexpr int GRACE_MS = 5000;
+
+        void send(const std::string &command) {
+            const std::string line = command + "\n";
+            std::size_t written = 0;
+            while (written < line.size()) {
+                const ssize_t n = ::write(toEngine_, line.data() + written, line.size() - written);
+                if (n < 0 && errno == EINTR) continue;
+                if (n <= 0) return;
+                written += static_cast<std::size_t>(n);
+            }
+        }
+
+        // Options the engine did not announce are skipped, as StockfishClient does.
+        bool hasOption(const std::string &name) const {
+            return std::find(options_.begin(), options_.end(), name) != options_.end();
+        }
+
+        void setOption(const std::string &name, const std::string &value) {
+            if (hasOption(name)) send(UciProtocol::setOption(name, value));
+        }
+
+        std::optional<std::string> readLine(Clock::time_point deadline) {
+            for (;;) {
+                if (auto line = lines_.next()) return std::string(*line);
+                const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now()).count();
+                if (left <= 0) return std::nullopt;
+                pollfd fd{fromEngine_, POLLIN, 0};
+                const int ready = ::poll(&fd, 1, static_cast<int>(left));
+                if (ready < 0 && errno == EINTR) continue;
+                if (ready <= 0) return std::nullopt;
+                char chunk[4096];
+                const ssize_t n = ::read(fromEngine_, chunk, sizeof chunk);
+                if (n <= 0) return std::nullopt;
+                lines_.append(std::string_view(chunk, static_cast<std::size_t>(n)));
+            }
+        }
+
+        bool waitFor(const std::string &token, int timeoutMs) {
+            const auto deadline = Clock::now() + std::chrono::milliseconds(timeoutMs);
+            while (auto line = readLine(deadline)) {
+                if (*line == token) return true;
+            }
+            return false;
+        }
+
+        EngineSpec spec_;
+        pid_t pid_ = -1;
+        int toEngine_ = -1;
+        int fromEngine_ = -1;
+        UciProtocol::LineBuffer lines_;
+        std::vector<std::string> options_;
+    };
+
+    std::unique_ptr<Player> createPlayer(const EngineSpec &spec) {
+        if (spec.command.empty()) return std::make_unique<BuiltinPlayer>(spec);
+        auto player = std::make_unique<UciPlayer>(spec);
+        if (!player->start()) return nullptr;
+        return player;
+    }
+
+    struct GameRecord {
+        int round = 0;
+        std::string white;
+        std::string black;
+        std::string startFen;
+        std::vector<std::string> san;
+        std::string result;       // "1-0", "0-1" or "1/2-1/2"
+        std::string termination;
+    };
+
+    std::string lossFor(Color side) {
+        return side == Color::White ? "0-1" : "1-0";
+    }
+
+    GameRecord playGame(Player &white, Player &black, const std::string &startFen,
+                        const TimeControl &tc, int maxPlies) {
+        GameRecord game;
+        game.startFen = startFen;
+        auto state = GameState::fromFEN(startFen);
+        std::vector<std::string> moves;
+        std::int64_t clockMs[2] = {tc.baseMs, tc.baseMs};
+
+        if (!white.newGame() || !black.newGame()) {
+            game.result = "*";
+            game.termination = "engine failure";
+            return game;
+        }
+        for (;;) {
+            const Color side = state->sideToMove();
+            MoveList legal;
+            MoveGenerator::generateLegal(*state, legal);
+            if (legal.empty()) {
+                const bool mated = MoveGenerator::isInCheck(state->board(), side);
+                game.result = mated ? lossFor(side) : "1/2-1/2";
+                game.termination = mated ? "checkmate" : "stalemate";
+                break;
+            }
+            if (state->repetitionCount() >= 3) {
+                game.result = "1/2-1/2";
+                game.termination = "threefold repetition";
+                break;
+            }
+            if (state->halfmoveClock() >= 100) {
+                game.result = "1/2-1/2";
+                game.termination = "fifty-move rule";
+                break;
+            }
+            if (maxPlies > 0 && static_cast<int>(moves.size()) >= maxPlies) {
+                game.result = "1/2-1/2";
+                game.termination = "adjudication: move limit";
+                break;
+            }
+
+            Player &player = side == Color::White ? white : black;
+            const auto started = Clock::now();
+            const std::string uci = player.bestMove(startFen, moves, *state, tc, clockMs);
+            const auto spent = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - started).count();
+
+            const int us = static_cast<int>(side);
+            if (tc.movetimeMs <= 0 && tc.baseMs > 0) {
+                clockMs[us] -= spent;
+                if (clockMs[us] < 0) {
+                    game.result = lossFor(side);
+                    game.termination = "time forfeit";
+                    break;
+                }
+                clockMs[us] += tc.incrementMs;
+            }
+            const auto it = std::find_if(legal.begin(), legal.end(), [&](PackedMove m) { return m.toUCI() == uci; });
+            if (it == legal.end()) {
+                game.result = lossFor(side);
+                game.termination = uci.empty() ? "no move" : "illegal move " + uci;
+                break;
+            }
+            game.san.push_back(San::fromMove(*state, *it));
+            state->applyMove(*it);
+            moves.push_back(uci);
+        }
+        return game;
+    }
+
+    std::string toPgn(const GameRecord &game, const std::string &date) {
+        std::ostringstream out;
+        out << "[Event \"Engine match\"]\n"
+            << "[Site \"?\"]\n"
+            << "[Date \"" << date << "\"]\n"
+            << "[Round \"" << game.round << "\"]\n"
+            << "[White \"" << game.white << "\"]\n"
+            << "[Black \"" << game.black << "\"]\n"
+            << "[Result \"" << game.result << "\"]\n";
+        if (game.startFen != STARTPOS) {
+            out << "[SetUp \"1\"]\n"
+                << "[FEN \"" << game.startFen << "\"]\n";
+        }
+        out << "[Termination \"" << game.termination << "\"]\n\n";
+
+        // Move numbers continue from the FEN's fullmove counter.
+        std::istringstream fields(game.startFen);
+        std::string field, side;
+        int moveNumber = 1;
+        for (int i = 0; fields >> field; ++i) {
+            if (i == 1) side = field;
+            if (i == 5) moveNumber = std::max(1, std::atoi(field.c_str()));
+        }
+        bool whiteToMove = side != "b";
+
+        std::string line;
+        auto emit = [&](const std::string &token) {
+            if (!line.empty() && line.size() + 1 + token.size() > 79) {
+                out << line << "\n";
+                line.clear();
+            }
+            if (!line.empty()) line += ' ';
+            line += token;
+        };
+        for (std::size_t i = 0; i < game.san.size(); ++i) {
+            if (whiteToMove) emit(std::to_string(moveNumber) + ".");
+            else if (i == 0) emit(std::to_string(moveNumber) + "...");
+            emit(game.san[i]);
+            if (!whiteToMove) ++moveNumber;
+            whiteToMove = !whiteToMove;
+        }
+        emit(game.result);
+        out << line << "\n\n";
+        return out.str();
+    }
+
+    double eloFromScore(double score) {
+        score = std::clamp(score, 1e-3, 1 - 1e-3);
+        return -400.0 * std::log10(1.0 / score - 1.0);
+    }
+
+    void printSummary(const EngineSpec &first, const EngineSpec &second, int wins, int draws, int losses) {
+        const int games = wins + draws + losses;
+        if (games == 0) return;
+        const double score = (wins + 0.5 * draws) / games;
+        // 95% interval from the per-game score variance.
+        const double variance = (wins * std::pow(1 - score, 2) + draws * std::pow(0.5 - score, 2)
+                                 + losses * std::pow(score, 2)) / games;
+        const double margin = 1.96 * std::sqrt(variance / games);
+        const double elo = eloFromScore(score);
+        const double errorElo = (eloFromScore(score + margin) - eloFromScore(score - margin)) / 2;
+
+        std::cout << first.name << " vs " << second.name << ": "
+                  << "+" << wins << " =" << draws << " -" << losses << "  (" << games << " games)\n"
+                  << std::fixed << std::setprecision(1)
+                  << "score " << 100 * score << "%  Elo difference " << std::showpos << elo << std::noshowpos
+                  << " +/- " << errorElo << "\n";
+    }
+}
+
+int main(int argc, char *argv[]) {
+    std::optional<EngineSpec> first, second;
+    int games = 2;
+    int concurrency = 1;
+    int maxPlies = 400;
+    TimeControl tc{.movetimeMs = 100};
+    std::string openingsPath, pgnPath;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--engine1" && hasValue) first = parseSpec(argv[++i]);
+        else if (arg == "--engine2" && hasValue) second = parseSpec(argv[++i]);
+        else if (arg == "--games" && hasValue) games = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--concurrency" && hasValue) concurrency = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--maxplies" && hasValue) maxPlies = std::max(0, std::atoi(argv[++i]));
+        else if (arg == "--movetime" && hasValue) tc = {.movetimeMs = std::max(1, std::atoi(argv[++i]))};
+        else if (arg == "--tc" && hasValue) {
+            const std::string value = argv[++i];
+            const auto plus = value.find('+');
+            tc = {.baseMs = std::atoll(value.substr(0, plus).c_str()),
+                  .incrementMs = plus == std::string::npos ? 0 : std::atoll(value.substr(plus + 1).c_str())};
+            if (tc.baseMs <= 0) {
+                printUsage();
+                return EXIT_FAILURE;
+            }
+        }
+        else if (arg == "--openings" && hasValue) openingsPath = argv[++i];
+        else if (arg == "--pgn" && hasValue) pgnPath = argv[++i];
+        else {
+            printUsage();
+            return EXIT_FAILURE;
+        }
+    }
+    if (!first || !second) {
+        printUsage();
+        return EXIT_FAILURE;
+    }
+    if (first->name == second->name) {
+        first->name += " (1)";
+        second->name += " (2)";
+    }
+
+    std::vector<std::string> openings;
+    if (openingsPath.empty()) {
+        for (const std::string &moves: DEFAULT_OPENINGS) openings.push_back(*fenAfter(moves));
+    } else {
+        std::ifstream in(openingsPath);
+        if (!in) {
+            std::cerr << "cannot read " << openingsPath << "\n";
+            return EXIT_FAILURE;
+        }
+        std::string line;
+        while (std::getline(in, line)) {
+            if (line.empty() || line[0] == '#') continue;
+            if (!GameState::fromFEN(line)) {
+                std::cerr << "invalid FEN: " << line << "\n";
+                return EXIT_FAILURE;
+            }
+            openings.push_back(line);
+        }
+        if (openings.empty()) {
+            std::cerr << "no openings in " << openingsPath << "\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::ofstream pgn;
+    if (!pgnPath.empty()) {
+        pgn.open(pgnPath);
+        if (!pgn) {
+            std::cerr << "cannot write " << pgnPath << "\n";
+            return EXIT_FAILURE;
+        }
+    }
+    // An engine that exits mid-game must not take the runner down with it.
+    std::signal(SIGPIPE, SIG_IGN);
+
+    char date[16];
+    const std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof date, "%Y.%m.%d", std::localtime(&now));
+
+    std::atomic<int> next{0};
+    std::atomic<bool> failed{false};
+    std::mutex outputMutex;
+    int wins = 0, draws = 0, losses = 0;
+
+    auto worker = [&] {
+        // Every worker owns a pair of engines, so K workers play K games at once.
+        auto one = createPlayer(*first);
+        auto two = createPlayer(*second);
+        if (!one || !two) {
+            std::lock_guard lock(outputMutex);
+            std::cerr << "cannot start " << (one ? second : first)->name << "\n";
+            failed = true;
+            return;
+        }
+        for (int index = next++; index < games && !failed; index = next++) {
+            // Consecutive games share an opening with colours reversed.
+            const bool firstIsWhite = index % 2 == 0;
+            const std::string &opening = openings[static_cast<std::size_t>(index / 2) % openings.size()];
+            GameRecord game = firstIsWhite ? playGame(*one, *two, opening, tc, maxPlies)
+                                           : playGame(*two, *one, opening, tc, maxPlies);
+            game.round = index + 1;
+            game.white = firstIsWhite ? first->name : second->name;
+            game.black = firstIsWhite ? second->name : first->name;
+
+            std::lock_guard lock(outputMutex);
+            const std::string firstWins = firstIsWhite ? "1-0" : "0-1";
+            if (game.result == "1/2-1/2") ++draws;
+            else if (game.result == firstWins) ++wins;
+            else if (game.result != "*") ++losses;
+            std::cerr << "game " << game.round << ": " << game.white << " - " << game.black << " "
+                      << game.result << " (" << game.termination << ")\n";
+            if (pgn) pgn << toPgn(game, date) << std::flush;
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < std::min(concurrency, games); ++i) threads.emplace_back(worker);
+    for (auto &thread: threads) thread.join();
+
+    printSummary(*first, *second, wins, draws, losses);
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
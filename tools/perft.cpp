@@ -0,0 +1,91 @@
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include "../src/GameState.h"
+#include "../src/Perft.h"
+#include "../src/TranspositionTable.h"
+
+namespace {
+    void printUsage() {
+        std::cerr << "usage: perft <depth> [--divide] [--threads N] [--hash MB] [--fen \"<fen>\"]\n"
+                  << "       perft --bench [--threads N] [--hash MB]\n";
+    }
+
+    void report(std::uint64_t nodes, std::chrono::steady_clock::duration elapsed) {
+        const double seconds = std::chrono::duration<double>(elapsed).count();
+        std::cout << "nodes " << nodes
+                  << "  time " << static_cast<long long>(seconds * 1000) << " ms"
+                  << "  nps " << static_cast<long long>(seconds > 0 ? nodes / seconds : 0) << "\n";
+    }
+
+    int runBench(int threads, TranspositionTable *tt) {
+        int failures = 0;
+        std::uint64_t total = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for (const auto &ref: Perft::referencePositions()) {
+            auto state = GameState::fromFEN(ref.fen);
+            const std::uint64_t nodes = state ? Perft::runParallel(*state, ref.depth, threads, tt) : 0;
+            total += nodes;
+            const bool ok = nodes == ref.nodes;
+            failures += ok ? 0 : 1;
+            std::cout << (ok ? "ok   " : "FAIL ") << ref.name << " depth " << ref.depth
+                      << ": " << nodes << " (expected " << ref.nodes << ")\n";
+        }
+        report(total, std::chrono::steady_clock::now() - start);
+        return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    int depth = -1;
+    int threads = 1;
+    int hashMb = 0;
+    bool bench = false;
+    bool divide = false;
+    std::string fen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--bench") bench = true;
+        else if (arg == "--divide") divide = true;
+        else if (arg == "--threads" && i + 1 < argc) threads = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--hash" && i + 1 < argc) hashMb = std::max(0, std::atoi(argv[++i]));
+        else if (arg == "--fen" && i + 1 < argc) fen = argv[++i];
+        else if (depth < 0 && !arg.empty() && std::isdigit(static_cast<unsigned char>(arg[0]))) depth = std::atoi(arg.c_str());
+        else {
+            printUsage();
+            return EXIT_FAILURE;
+        }
+    }
+    std::unique_ptr<TranspositionTable> tt;
+    if (hashMb > 0) tt = std::make_unique<TranspositionTable>(hashMb);
+
+    if (bench) return runBench(threads, tt.get());
+    if (depth < 0) {
+        printUsage();
+        return EXIT_FAILURE;
+    }
+
+    auto state = GameState::fromFEN(fen);
+    if (!state) {
+        std::cerr << "invalid FEN: " << fen << "\n";
+        return EXIT_FAILURE;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    std::uint64_t nodes = 0;
+    if (divide) {
+        for (const auto &entry: Perft::divide(*state, depth, threads, tt.get())) {
+            std::cout << entry.move.toUCI() << ": " << entry.nodes << "\n";
+            nodes += entry.nodes;
+        }
+    } else {
+        nodes = Perft::runParallel(*state, depth, threads, tt.get());
+    }
+    report(nodes, std::chrono::steady_clock::now() - start);
+    return EXIT_SUCCESS;
+}